@@ -0,0 +1,199 @@
+#include "bench.h"
+#include "cc_interface.h"
+#include "flasher_controller.h"
+#include "version.h"
+#include <LittleFS.h>
+
+// --- CONFIGURATION ---
+const char* BENCH_PATH = "/bench.json";          // Last report
+const char* BENCH_HISTORY_PATH = "/bench.log";   // One report per line
+const size_t BENCH_HISTORY_MAX = 32768;
+const uint16_t BENCH_FRAMES = 500;               // Frames per link measurement
+const uint16_t BENCH_SCRATCH = 0xF000;           // XDATA scratch RAM (also used by the flash loader)
+const uint16_t BENCH_SCRATCH_LEN = 256;
+const uint32_t BENCH_READ_LEN = 4096;            // Bytes per code read measurement
+const uint32_t BENCH_IMAGE_LEN = 16384;          // Synthetic image (destructive run)
+const uint16_t BENCH_BUF = 1024;
+
+static volatile bool benchRunning = false;
+
+// Bytes (or frames) per second
+static uint32_t rate(uint32_t count, uint32_t us) {
+    return us ? (uint32_t)((uint64_t)count * 1000000ULL / us) : 0;
+}
+
+// Deterministic, not erased-looking test pattern
+static uint8_t patternByte(uint32_t addr) {
+    return (uint8_t)((addr * 7) ^ (addr >> 8) ^ 0x5A);
+}
+
+static void fillPattern(uint8_t* buf, uint32_t addr, uint16_t len) {
+    for(uint16_t i = 0; i < len; i++) buf[i] = patternByte(addr + i);
+}
+
+static void benchLink(String &json) {
+    // Raw byte timing: GET_STATUS is one byte out, one byte in and has no side effects
+    uint32_t txUs = 0, rxUs = 0;
+    for(uint16_t i = 0; i < BENCH_FRAMES; i++) {
+        uint32_t t0 = micros();
+        cc.cc_send_byte(0x34);
+        uint32_t t1 = micros();
+        cc.cc_receive_byte();
+        rxUs += micros() - t1;
+        txUs += t1 - t0;
+    }
+    json += "\"link_tx_bps\":" + String(rate(BENCH_FRAMES, txUs)) + ",";
+    json += "\"link_rx_bps\":" + String(rate(BENCH_FRAMES, rxUs)) + ",";
+
+    uint32_t t0 = micros();
+    for(uint16_t i = 0; i < BENCH_FRAMES; i++) cc.opcode(0x00); // NOP
+    json += "\"opcode_fps\":" + String(rate(BENCH_FRAMES, micros() - t0)) + ",";
+}
+
+static void benchXdata(String &json, uint8_t* buf, uint8_t* saved) {
+    cc.read_xdata_memory(BENCH_SCRATCH, BENCH_SCRATCH_LEN, saved);
+
+    fillPattern(buf, 0, BENCH_SCRATCH_LEN);
+    uint32_t t0 = micros();
+    cc.write_xdata_memory(BENCH_SCRATCH, BENCH_SCRATCH_LEN, buf);
+    uint32_t writeUs = micros() - t0;
+
+    t0 = micros();
+    cc.read_xdata_memory(BENCH_SCRATCH, BENCH_SCRATCH_LEN, buf);
+    uint32_t readUs = micros() - t0;
+
+    bool ok = true;
+    for(uint16_t i = 0; i < BENCH_SCRATCH_LEN; i++) if(buf[i] != patternByte(i)) { ok = false; break; }
+    cc.write_xdata_memory(BENCH_SCRATCH, BENCH_SCRATCH_LEN, saved);
+
+    json += "\"xdata_read_bps\":" + String(rate(BENCH_SCRATCH_LEN, readUs)) + ",";
+    json += "\"xdata_write_bps\":" + String(rate(BENCH_SCRATCH_LEN, writeUs)) + ",";
+    json += "\"xdata_ok\":" + String(ok ? "true" : "false") + ",";
+}
+
+static void benchCodeRead(String &json, uint8_t* buf) {
+    const uint16_t sizes[] = { 16, 64, 256, 1024 };
+    json += "\"code_read_bps\":{";
+    for(uint8_t s = 0; s < 4; s++) {
+        uint32_t t0 = micros();
+        for(uint32_t addr = 0; addr < BENCH_READ_LEN; addr += sizes[s]) cc.read_code_memory(addr, sizes[s], buf);
+        json += "\"" + String(sizes[s]) + "\":" + String(rate(BENCH_READ_LEN, micros() - t0));
+        json += (s < 3) ? "," : "},";
+    }
+}
+
+// Erases the chip, then writes, verifies and dumps a synthetic image
+static void benchDestructive(String &json, uint8_t* buf, uint8_t* chipBuf) {
+    uint32_t t0 = millis();
+    uint8_t eraseResult = cc.erase_chip();
+    json += "\"erase_chip_ms\":" + String(millis() - t0) + ",";
+    if(eraseResult != 0) { json += "\"erase_ok\":false,"; return; }
+
+    // write_code_memory() with different block sizes, each into fresh flash
+    const uint16_t sizes[] = { 64, 256, 1024 };
+    uint32_t addr = BENCH_IMAGE_LEN;
+    json += "\"code_write_bps\":{";
+    for(uint8_t s = 0; s < 3; s++) {
+        uint32_t t0 = micros();
+        for(uint32_t off = 0; off < BENCH_BUF; off += sizes[s]) {
+            fillPattern(buf, addr + off, sizes[s]);
+            cc.write_code_memory(addr + off, buf, sizes[s]);
+        }
+        json += "\"" + String(sizes[s]) + "\":" + String(rate(BENCH_BUF, micros() - t0));
+        json += (s < 2) ? "," : "},";
+        addr += BENCH_BUF;
+    }
+
+    // End-to-end: flash, verify and dump of the synthetic image (job chunk size)
+    bool ok = true;
+    t0 = millis();
+    for(uint32_t a = 0; a < BENCH_IMAGE_LEN && ok; a += BENCH_BUF) {
+        fillPattern(buf, a, BENCH_BUF);
+        ok = (cc.write_code_memory(a, buf, BENCH_BUF) == 0);
+    }
+    uint32_t flashMs = millis() - t0;
+
+    t0 = millis();
+    for(uint32_t a = 0; a < BENCH_IMAGE_LEN && ok; a += BENCH_BUF) {
+        fillPattern(buf, a, BENCH_BUF);
+        cc.read_code_memory(a, BENCH_BUF, chipBuf);
+        ok = (memcmp(buf, chipBuf, BENCH_BUF) == 0);
+    }
+    uint32_t verifyMs = millis() - t0;
+
+    t0 = millis();
+    for(uint32_t a = 0; a < BENCH_IMAGE_LEN; a += BENCH_BUF) cc.read_code_memory(a, BENCH_BUF, chipBuf);
+    uint32_t dumpMs = millis() - t0;
+
+    json += "\"e2e\":{\"size\":" + String(BENCH_IMAGE_LEN) + ",\"flash_ms\":" + String(flashMs) +
+            ",\"verify_ms\":" + String(verifyMs) + ",\"dump_ms\":" + String(dumpMs) +
+            ",\"ok\":" + String(ok ? "true" : "false") + "},";
+}
+
+static void storeReport(const String &json) {
+    File f = LittleFS.open(BENCH_PATH, "w");
+    if(f) { f.write((const uint8_t*)json.c_str(), json.length()); f.close(); }
+
+    if(LittleFS.exists(BENCH_HISTORY_PATH)) {
+        File h = LittleFS.open(BENCH_HISTORY_PATH, "r");
+        size_t size = h.size(); h.close();
+        if(size + json.length() > BENCH_HISTORY_MAX) LittleFS.remove(BENCH_HISTORY_PATH);
+    }
+    File h = LittleFS.open(BENCH_HISTORY_PATH, "a");
+    if(h) { h.write((const uint8_t*)json.c_str(), json.length()); h.write('\n'); h.close(); }
+}
+
+void task_Bench(void * parameter) {
+    bool destructive = (parameter != NULL);
+    uint8_t buf[BENCH_BUF];
+    uint8_t chipBuf[BENCH_BUF];
+
+    cc.enable_cc_debug();
+    uint8_t clk = cc.clock_init();
+    uint16_t raw_id = cc.send_cc_cmd(0x68); // GET_CHIP_ID
+
+    String json = "{";
+    json += "\"fw\":\"" FW_VERSION "\",";
+    json += "\"uptime_ms\":" + String(millis()) + ",";
+    json += "\"chip_id\":\"0x" + String(raw_id, HEX) + "\",";
+    json += "\"link\":{\"clk_delay_us\":" + String(cc.get_clock_delay()) + ",\"cpu_mhz\":" + String(ESP.getCpuFreqMHz()) + "},";
+    json += "\"destructive\":" + String(destructive ? "true" : "false") + ",";
+
+    if(clk != 0) {
+        json += "\"error\":\"Chip not responding\"}";
+    } else {
+        uint32_t t0 = millis();
+        benchLink(json);
+        benchXdata(json, buf, chipBuf);
+        benchCodeRead(json, buf);
+        if(destructive) benchDestructive(json, buf, chipBuf);
+        json += "\"total_ms\":" + String(millis() - t0) + "}";
+        cc.reset_cc();
+    }
+
+    storeReport(json);
+    benchRunning = false;
+    releaseLink();
+    vTaskDelete(NULL);
+}
+
+// --- PUBLIC INTERFACE ---
+
+bool startBenchTask(bool destructive) {
+    if(!acquireLink()) return false;
+    benchRunning = true;
+    xTaskCreate(task_Bench, "Bench", 8192, destructive ? (void*)1 : NULL, 1, NULL);
+    return true;
+}
+
+bool isBenchRunning() {
+    return benchRunning;
+}
+
+String getBenchReport() {
+    File f = LittleFS.open(BENCH_PATH, "r");
+    if(!f) return String();
+    String json = f.readString();
+    f.close();
+    return json;
+}
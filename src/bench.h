@@ -0,0 +1,15 @@
+#pragma once
+#include <Arduino.h>
+
+// --- ON-DEVICE BENCHMARK ---
+// Reproducible throughput measurements of the debug link and the job
+// primitives against the connected target. Reports are stored in LittleFS
+// together with firmware version and link settings.
+
+// destructive = also erase the chip and program a synthetic pattern image
+// Returns: true = Task started, false = System busy
+bool startBenchTask(bool destructive);
+bool isBenchRunning();
+
+// Last report (JSON) or empty String if none exists
+String getBenchReport();
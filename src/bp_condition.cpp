@@ -0,0 +1,118 @@
+#include "bp_condition.h"
+#include "cc_interface.h"
+#include "debug_channel.h"
+#include <stdlib.h>
+
+enum BpOp : uint8_t { OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE, OP_CHANGED };
+const uint8_t SPACE_HITS = 0xFF;
+
+static const char* skipSpace(const char* p) {
+    while(*p == ' ') p++;
+    return p;
+}
+
+// Decimal or 0x hex; false = no digits
+static bool parseNumber(const char* &p, uint32_t &v) {
+    char* end;
+    bool hex = p[0] == '0' && (p[1] == 'x' || p[1] == 'X');
+    v = strtoul(p, &end, hex ? 16 : 10);
+    if(end == p) return false;
+    p = end;
+    return true;
+}
+
+static bool parseTerm(const char* &p, BpTerm &t) {
+    t = {};
+    t.mask = 0xFFFF;
+    t.width = 1;
+    p = skipSpace(p);
+    if(!strncmp(p, "hits", 4)) {
+        t.space = SPACE_HITS;
+        p += 4;
+    } else {
+        if(*p == 'x') t.space = MEM_XDATA;
+        else if(*p == 'i') t.space = MEM_IDATA;
+        else if(*p == 's') t.space = MEM_SFR;
+        else return false;
+        p++;
+        if(!strncmp(p, "16", 2) && t.space != MEM_SFR) { t.width = 2; p += 2; }
+        if(*p++ != ':') return false;
+        char* end;
+        uint32_t addr = strtoul(p, &end, 16);
+        if(end == p) return false;
+        p = end;
+        uint32_t limit = (t.space == MEM_XDATA) ? 0x10000 : 0x100;
+        if(addr + t.width > limit || (t.space == MEM_SFR && addr < 0x80)) return false;
+        t.addr = addr;
+    }
+    p = skipSpace(p);
+    if(*p == '&') {
+        uint32_t mask;
+        p = skipSpace(p + 1);
+        if(!parseNumber(p, mask)) return false;
+        t.mask = mask;
+        p = skipSpace(p);
+    }
+    static const struct { const char* s; uint8_t op; } OPS[] = {
+        { "==", OP_EQ }, { "!=", OP_NE }, { "<=", OP_LE }, { ">=", OP_GE }, { "<", OP_LT }, { ">", OP_GT },
+        { "changed", OP_CHANGED }
+    };
+    for(const auto &o : OPS) {
+        size_t n = strlen(o.s);
+        if(strncmp(p, o.s, n)) continue;
+        p += n;
+        t.op = o.op;
+        if(o.op == OP_CHANGED) return true;
+        p = skipSpace(p);
+        return parseNumber(p, t.value);
+    }
+    return false;
+}
+
+bool parseBpCondition(const char* text, BpCondition &c) {
+    BpCondition parsed = {};
+    const char* p = skipSpace(text);
+    if(strlen(text) >= BP_COND_TEXT) return false;
+    while(*p) {
+        if(parsed.terms == BP_COND_TERMS || !parseTerm(p, parsed.term[parsed.terms])) return false;
+        parsed.terms++;
+        p = skipSpace(p);
+        if(!*p) break;
+        if(strncmp(p, "&&", 2)) return false;
+        p = skipSpace(p + 2);
+        if(!*p) return false; // "&&" without a term behind it
+    }
+    strcpy(parsed.text, text);
+    c = parsed;
+    return true;
+}
+
+static uint32_t readOperand(const BpTerm &t, uint32_t hits) {
+    if(t.space == SPACE_HITS) return hits;
+    uint8_t b[2] = { 0, 0 };
+    if(t.space == MEM_XDATA) cc.peek_xdata(t.addr, t.width, b);
+    else if(t.space == MEM_IDATA) cc.read_idata_memory(t.addr, t.width, b);
+    else cc.read_sfr_memory(t.addr, 1, b);
+    return (b[0] | (b[1] << 8)) & t.mask;
+}
+
+bool evaluateBpCondition(BpCondition &c, uint32_t hits) {
+    bool stop = true;
+    // No early exit: "changed" terms must see every hit
+    for(uint8_t i = 0; i < c.terms; i++) {
+        BpTerm &t = c.term[i];
+        uint32_t v = readOperand(t, hits);
+        bool r;
+        switch(t.op) {
+            case OP_EQ: r = v == t.value; break;
+            case OP_NE: r = v != t.value; break;
+            case OP_LT: r = v < t.value; break;
+            case OP_LE: r = v <= t.value; break;
+            case OP_GT: r = v > t.value; break;
+            case OP_GE: r = v >= t.value; break;
+            default:    r = t.seen && v != t.last; t.last = v; t.seen = true; break;
+        }
+        stop = stop && r;
+    }
+    return stop;
+}
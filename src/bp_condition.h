@@ -0,0 +1,38 @@
+#pragma once
+#include <Arduino.h>
+
+// --- BREAKPOINT CONDITIONS ---
+// Condition of a conditional breakpoint, evaluated on the ESP at every hit.
+// Up to BP_COND_TERMS terms joined by "&&":
+//   <operand>[&<mask>] <op> <value>   op: == != < <= > >=
+//   <operand>[&<mask>] changed        (value differs from the previous hit)
+// Operands: x:<hex> XDATA, i:<hex> IDATA, s:<hex> SFR byte, x16:/i16: 16-bit
+// little endian, hits = hits of this breakpoint (including this one).
+// Values and masks: decimal or 0x hex. Examples:
+//   x16:F000 == 1000      i:30&0x80 != 0 && hits > 10      s:90 changed
+
+const uint8_t BP_COND_TERMS = 4;
+const size_t BP_COND_TEXT = 64;
+
+struct BpTerm {
+    uint8_t space;     // MemSpace, 0xFF = hits
+    uint8_t width;     // 1 or 2 bytes
+    uint8_t op;
+    uint16_t addr;
+    uint16_t mask;
+    uint32_t value;
+    uint32_t last;     // "changed": value of the previous hit
+    bool seen;         // "changed": last is valid
+};
+
+struct BpCondition {
+    uint8_t terms;     // 0 = unconditional
+    BpTerm term[BP_COND_TERMS];
+    char text[BP_COND_TEXT];
+};
+
+// false = syntax error (c is left unconditional)
+bool parseBpCondition(const char* text, BpCondition &c);
+
+// All terms true -> stop. Link held, CPU halted; A, DPTR and R0 are kept.
+bool evaluateBpCondition(BpCondition &c, uint32_t hits);
@@ -0,0 +1,161 @@
+#include "breakpoints.h"
+#include "cc_interface.h"
+#include "debug_channel.h"
+
+// --- CONFIGURATION ---
+const uint8_t SFR_MEMCTR = 0xC7;
+
+enum BpSlot : uint8_t { BP_FREE, BP_USER, BP_TEMP };
+
+struct BpStats {
+    uint32_t hits, stops, resumes;
+    uint32_t lastUs, maxUs;
+    uint64_t sumUs;
+};
+
+static uint8_t slotState[BP_COUNT] = {};
+static uint32_t slotAddress[BP_COUNT] = {};
+static BpCondition slotCond[BP_COUNT];
+static BpStats slotStats[BP_COUNT];
+static volatile bool resumed = false;
+
+static void writeSlot(uint8_t i) {
+    cc.write_hw_breakpoint(i, slotAddress[i], slotState[i] != BP_FREE);
+}
+
+int8_t bpSet(uint32_t address, const BpCondition* cond) {
+    if(address > BP_MAX_ADDRESS) return -1;
+    int8_t slot = -1;
+    for(uint8_t i = 0; i < BP_COUNT; i++) {
+        if(slotState[i] == BP_USER && slotAddress[i] == address) { slot = i; break; }
+        if(slotState[i] == BP_FREE && slot < 0) slot = i;
+    }
+    if(slot < 0) return -1;
+    slotCond[slot] = {};
+    if(cond) slotCond[slot] = *cond;
+    slotStats[slot] = {};
+    if(slotState[slot] == BP_USER) return slot; // Comparator already set
+    slotState[slot] = BP_USER;
+    slotAddress[slot] = address;
+    writeSlot(slot);
+    return slot;
+}
+
+bool bpClear(uint32_t address) {
+    for(uint8_t i = 0; i < BP_COUNT; i++) {
+        if(slotState[i] != BP_USER || slotAddress[i] != address) continue;
+        slotState[i] = BP_FREE;
+        writeSlot(i);
+        return true;
+    }
+    return false;
+}
+
+void bpClearAll() {
+    for(uint8_t i = 0; i < BP_COUNT; i++) {
+        if(slotState[i] != BP_USER) continue;
+        slotState[i] = BP_FREE;
+        writeSlot(i);
+    }
+}
+
+void bpRestore() {
+    for(uint8_t i = 0; i < BP_COUNT; i++) if(slotState[i] == BP_USER) writeSlot(i);
+}
+
+// Highest free comparator, so the user set keeps the low numbers
+int8_t bpArmTemp(uint32_t address) {
+    for(int8_t i = BP_COUNT - 1; i >= 0; i--) {
+        if(slotState[i] != BP_FREE) continue;
+        slotState[i] = BP_TEMP;
+        slotAddress[i] = address;
+        writeSlot(i);
+        return i;
+    }
+    return -1;
+}
+
+void bpDisarmTemp(int8_t index) {
+    if(index < 0 || index >= BP_COUNT || slotState[index] != BP_TEMP) return;
+    slotState[index] = BP_FREE;
+    writeSlot(index);
+}
+
+uint8_t bpList(uint32_t addresses[BP_COUNT], uint8_t indices[BP_COUNT]) {
+    uint8_t n = 0;
+    for(uint8_t i = 0; i < BP_COUNT; i++) {
+        if(slotState[i] != BP_USER) continue;
+        addresses[n] = slotAddress[i];
+        indices[n++] = i;
+    }
+    return n;
+}
+
+void bpNoteResume() {
+    resumed = true;
+}
+
+void bpNoteStop() {
+    resumed = false;
+}
+
+bool bpConditionsArmed() {
+    for(uint8_t i = 0; i < BP_COUNT; i++) if(slotState[i] == BP_USER && slotCond[i].terms) return true;
+    return false;
+}
+
+bool bpFilterHit() {
+    if(!resumed || !bpConditionsArmed()) return false;
+    uint32_t start = micros();
+    uint32_t addr = codeAddress(cc.read_pc());
+    for(uint8_t i = 0; i < BP_COUNT; i++) {
+        if(slotState[i] != BP_USER || slotAddress[i] != addr) continue;
+        BpStats &st = slotStats[i];
+        st.hits++;
+        if(!slotCond[i].terms || evaluateBpCondition(slotCond[i], st.hits)) {
+            st.stops++;
+            resumed = false; // Stopped for the debugger now: no second evaluation of this halt
+            return false;
+        }
+        cc.debug_continue();
+        uint32_t us = micros() - start;
+        st.resumes++;
+        st.lastUs = us;
+        if(us > st.maxUs) st.maxUs = us;
+        st.sumUs += us;
+        return true;
+    }
+    return false; // Not a user breakpoint (temporary one, 0xA5)
+}
+
+size_t formatBreakpointsJSON(char* buf, size_t len) {
+    uint32_t addr[BP_COUNT];
+    uint8_t idx[BP_COUNT];
+    uint8_t n = bpList(addr, idx);
+    size_t pos = snprintf(buf, len, "{\"max\":%u,\"bp\":[", BP_COUNT);
+    for(uint8_t i = 0; i < n && pos < len; i++) {
+        uint8_t bank = addr[i] >> 15;
+        uint16_t pc = (addr[i] < 0x8000) ? addr[i] : 0x8000 + (addr[i] & 0x7FFF);
+        const BpStats &st = slotStats[idx[i]];
+        pos += snprintf(buf + pos, len - pos, "%s{\"n\":%u,\"flat\":\"0x%05lX\",\"bank\":%u,\"pc\":\"0x%04X\","
+                        "\"cond\":\"%s\",\"hits\":%lu,\"stops\":%lu,\"resumes\":%lu,"
+                        "\"last_us\":%lu,\"max_us\":%lu,\"avg_us\":%lu}",
+                        i ? "," : "", idx[i], (unsigned long)addr[i], bank, pc, slotCond[idx[i]].text,
+                        (unsigned long)st.hits, (unsigned long)st.stops, (unsigned long)st.resumes,
+                        (unsigned long)st.lastUs, (unsigned long)st.maxUs,
+                        (unsigned long)(st.resumes ? st.sumUs / st.resumes : 0));
+    }
+    if(pos < len) pos += snprintf(buf + pos, len - pos, "]}");
+    return pos;
+}
+
+uint32_t codeAddress(uint16_t pc, int16_t bank) {
+    if(pc < 0x8000 || !cc.is_cc253x()) return pc;
+    if(bank < 0) {
+        if(!cpuHalted(cc.get_status_byte())) return pc;
+        uint8_t memctr;
+        cc.read_sfrs(&SFR_MEMCTR, 1, &memctr);
+        bank = memctr & 0x07;
+    }
+    return (uint32_t)bank * 0x8000 + (pc - 0x8000);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <Arduino.h>
+#include "bp_condition.h"
+
+// --- BREAKPOINT MANAGER ---
+// The four hardware comparators of the debug unit, written with the native
+// SET_HW_BRKPNT command. It works while the CPU runs, so setting or clearing
+// a breakpoint no longer halts (resets) the target. The set is cached on the
+// ESP: listing costs no link traffic. Addresses are flat code addresses
+// (bank * 32 KB + offset above 0x8000 on CC253x, bank in bits 17:16 of the
+// command). A target reset clears the comparators; bpRestore() writes the
+// cache again. It is the CC interface's reset hook, so every reset into
+// debug mode (HALT, INIT, jobs, bench) restores the set. Run control
+// borrows a free comparator for its temporary breakpoint.
+// Functions that write need the link held.
+//
+// Conditional breakpoints (bp_condition.h): when the CPU halts on one after
+// a resume, bpFilterHit() evaluates the condition right away in the task
+// that saw the halt (halt watch, run control) and resumes the CPU again if
+// it is false. Hits, stops, auto-resumes and the halt-seen-to-resumed
+// latency are counted per breakpoint.
+
+const uint8_t BP_COUNT = 4;
+const uint32_t BP_MAX_ADDRESS = 0x3FFFF;   // 18 address bits (256 KB)
+
+// Comparator index, -1 = all four in use. Same address: same index (condition and counters replaced)
+int8_t bpSet(uint32_t address, const BpCondition* cond = nullptr);
+bool bpClear(uint32_t address);           // false = no breakpoint there
+void bpClearAll();                        // User breakpoints (a temporary one stays)
+void bpRestore();                         // Target was reset: write the cache again
+
+int8_t bpArmTemp(uint32_t address);       // Run control: free comparator, -1 = none
+void bpDisarmTemp(int8_t index);
+
+// Run state as the debugger left it: conditions are only evaluated for
+// halts after a resume (a step or HALT may stop anywhere, also on them)
+void bpNoteResume();
+void bpNoteStop();
+bool bpConditionsArmed();                 // Any conditional breakpoint (halt watch keeps polling)
+// CPU halted: true = it was a conditional breakpoint whose condition is false, CPU resumed
+bool bpFilterHit();
+
+// User breakpoints from the cache (no link): flat addresses, comparator numbers
+uint8_t bpList(uint32_t addresses[BP_COUNT], uint8_t indices[BP_COUNT]);
+size_t formatBreakpointsJSON(char* buf, size_t len);
+
+// PC (0x8000-0xFFFF: in a bank) -> flat code address. bank < 0: the bank
+// mapped right now (MEMCTR, CPU halted; while it runs the PC is taken as flat).
+uint32_t codeAddress(uint16_t pc, int16_t bank = -1);
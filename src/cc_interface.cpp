@@ -1,5 +1,7 @@
 #include <Arduino.h>
 #include "cc_interface.h"
+#include "metrics.h"
+#include "link_trace.h"
 
 CC_interface cc; // Create global instance
 
@@ -28,6 +30,11 @@ void CC_interface::set_callback(callbackPtr callBack)
   _callback = callBack;
 }
 
+void CC_interface::set_reset_hook(resetHookPtr hook)
+{
+  _reset_hook = hook;
+}
+
 uint8_t CC_interface::set_lock_byte(uint8_t lock_byte)
 {
   lock_byte = lock_byte & 0x1f; // Mask to max lock byte value
@@ -109,6 +116,7 @@ uint8_t CC_interface::set_lock_byte(uint8_t lock_byte)
 
 uint8_t CC_interface::erase_chip()
 {
+  OpTimer timer(OP_ERASE_CHIP);
   opcode(0x00); // NOP
   send_cc_cmdS(0x14); // CMD_CHIP_ERASE
   
@@ -118,37 +126,39 @@ uint8_t CC_interface::erase_chip()
   {
     if (millis() - start > 1000) // Timeout increased to 1s
     {
+      linkMetrics.timeouts++;
       return 1; // Timeout Error
     }
   }
   return 0; // Success
 }
 
-void CC_interface::read_code_memory(uint32_t address, uint16_t len, uint8_t buffer[])
+uint8_t CC_interface::erase_page(uint32_t address)
 {
-  // 1. Bank berechnen (32KB Blöcke)
-  // Bank 0: 0x00000 - 0x07FFF (Physikalisch)
-  // Bank 1: 0x08000 - 0x0FFFF (Physikalisch) -> Mapped auf 0x8000
-  // Bank 2: 0x10000 - 0x17FFF (Physikalisch) -> Mapped auf 0x8000
-  // ...
-  uint8_t bank = address / 32768;      // Ganzzahl-Division durch 32k
-  uint16_t offset = address % 32768;   // Rest ist der Offset im 32k Block
-  uint16_t virtual_addr;
+  OpTimer timer(OP_ERASE_PAGE);
+  uint16_t faddr = address / get_flash_word_size(); // Word addressing (same as write_code_memory)
+  opcode(0x75, 0xAD, (faddr >> 8) & 0xff); // MOV FADDRH, #hi
+  opcode(0x75, 0xAC, faddr & 0xff);        // MOV FADDRL, #lo
+  opcode(0x75, 0xAE, 0x01);                // MOV FCTL,   #01 ; Start Page Erase
 
-  if (bank == 0) {
-    // Bank 0 liegt beim 8051 immer fest im unteren Bereich (0x0000 - 0x7FFF)
-    virtual_addr = offset;
-    // Wir müssen MEMCTR hier nicht zwingend setzen, da Bank 0 immer sichtbar ist,
-    // aber wir setzen MEMCTR auf 1, damit der obere Bereich definiert ist (Best Practice)
-    opcode(0x75, 0xC7, 0x01); 
-  } else {
-    // Alle anderen Banks (1-7) werden in das obere Fenster (0x8000 - 0xFFFF) eingeblendet
-    virtual_addr = 0x8000 + offset;
-    
-    // Bank auswählen: MOV MEMCTR, #bank
-    // Opcode 0x75 = MOV direct, #data. 0xC7 = Adresse von MEMCTR.
-    opcode(0x75, 0xC7, bank); 
+  // Wait until FCTL.BUSY (Bit 7) is cleared
+  unsigned long start = millis();
+  while (opcode(0xE5, 0xAE) & 0x80) // MOV A, FCTL
+  {
+    if (millis() - start > 100)
+    {
+      linkMetrics.timeouts++;
+      return 1; // Timeout Error
+    }
   }
+  return 0; // Success
+}
+
+void CC_interface::read_code_memory(uint32_t address, uint16_t len, uint8_t buffer[])
+{
+  OpTimer timer(OP_CODE_READ);
+  // 1. Bank einblenden (32KB Blöcke)
+  uint16_t virtual_addr = map_code_bank(address);
 
   // 2. DPTR setzen (Data Pointer)
   opcode(0x90, virtual_addr >> 8, virtual_addr);
@@ -179,6 +189,7 @@ void CC_interface::read_code_memory(uint32_t address, uint16_t len, uint8_t buff
 
 void CC_interface::read_xdata_memory(uint16_t address, uint16_t len, uint8_t buffer[])
 {
+  OpTimer timer(OP_XDATA_READ);
   opcode(0x90, address >> 8, address); // MOV DPTR
   for (int i = 0; i < len; i++)
   {
@@ -187,8 +198,77 @@ void CC_interface::read_xdata_memory(uint16_t address, uint16_t len, uint8_t buf
   }
 }
 
+void CC_interface::peek_xdata(uint16_t address, uint16_t len, uint8_t buffer[])
+{
+  uint8_t acc = opcode(0xE5, 0xE0);     // MOV A, ACC
+  uint8_t dp = active_dpl();
+  uint8_t dpl = opcode(0xE5, dp);       // MOV A, DPL
+  uint8_t dph = opcode(0xE5, dp + 1);   // MOV A, DPH
+  read_xdata_memory(address, len, buffer);
+  opcode(0x90, dph, dpl);               // MOV DPTR, #saved
+  opcode(0x74, acc);                    // MOV A, #saved
+}
+
+void CC_interface::peek_batch(const PeekItem items[], uint8_t count, uint8_t buffer[])
+{
+  bool useDptr = false, useR0 = false;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (items[i].space == PEEK_XDATA) useDptr = true;
+    if (items[i].space == PEEK_IDATA && items[i].address + items[i].len > 0x80) useR0 = true;
+  }
+  uint8_t acc = opcode(0xE5, 0xE0);           // MOV A, ACC
+  uint8_t dp = 0, dpl = 0, dph = 0, r0 = 0xFF, r0_val = 0;
+  if (useDptr)
+  {
+    dp = active_dpl();
+    dpl = opcode(0xE5, dp);                   // MOV A, DPL
+    dph = opcode(0xE5, dp + 1);               // MOV A, DPH
+  }
+  if (useR0)
+  {
+    r0 = opcode(0xE5, 0xD0) & 0x18;           // MOV A, PSW -> R0 of the active bank
+    r0_val = opcode(0xE5, r0);                // MOV A, R0
+  }
+
+  // Registers already changed by the batch are answered from the saved copies
+  for (uint8_t i = 0; i < count; i++)
+  {
+    const PeekItem &item = items[i];
+    if (item.space == PEEK_XDATA) opcode(0x90, item.address >> 8, item.address); // MOV DPTR
+    for (uint8_t j = 0; j < item.len; j++)
+    {
+      uint8_t addr = item.address + j;
+      if (item.space == PEEK_XDATA)
+      {
+        *buffer++ = opcode(0xE0);             // MOVX A, @DPTR
+        opcode(0xA3);                         // INC DPTR
+      }
+      else if (item.space == PEEK_SFR)
+      {
+        if (addr == 0xE0) *buffer++ = acc;
+        else if (useDptr && addr == dp) *buffer++ = dpl;
+        else if (useDptr && addr == dp + 1) *buffer++ = dph;
+        else *buffer++ = opcode(0xE5, addr);  // MOV A, direct
+      }
+      else if (addr == r0) *buffer++ = r0_val;
+      else if (addr < 0x80) *buffer++ = opcode(0xE5, addr); // MOV A, direct
+      else
+      {
+        opcode(0x78, addr);                   // MOV R0, #addr
+        *buffer++ = opcode(0xE6);             // MOV A, @R0
+      }
+    }
+  }
+
+  if (useDptr) opcode(0x90, dph, dpl);        // MOV DPTR, #saved
+  if (useR0) opcode(0x78, r0_val);            // MOV R0, #saved
+  opcode(0x74, acc);                          // MOV A, #saved
+}
+
 void CC_interface::write_xdata_memory(uint16_t address, uint16_t len, uint8_t buffer[])
 {
+  OpTimer timer(OP_XDATA_WRITE);
   opcode(0x90, address >> 8, address); // MOV DPTR
   for (int i = 0; i < len; i++)
   {
@@ -203,6 +283,17 @@ void CC_interface::set_pc(uint16_t address)
   opcode(0x02, address >> 8, address); // LJMP
 }
 
+void CC_interface::set_clock_delay(uint8_t us)
+{
+  _base_clk_delay_us = us;
+  _clk_delay_us = us;
+}
+
+uint8_t CC_interface::get_clock_delay()
+{
+  return _clk_delay_us;
+}
+
 uint8_t CC_interface::clock_init()
 {
   opcode(0x75, 0xc6, 0x00); // CLKCON CMD
@@ -225,29 +316,37 @@ uint8_t CC_interface::clock_init()
 
     if (millis() - start > 500) // Timeout increased to 500ms
     {
+      linkMetrics.timeouts++;
       return 1; // Timeout
     }
   }
 }
 
-uint8_t CC_interface::write_code_memory(uint16_t address, uint8_t buffer[], int len)
+uint8_t CC_interface::write_code_memory(uint32_t address, uint8_t buffer[], int len)
 {
   int entry_len = len;
-  if (len % 2 != 0)
-    len++;
   int position = 0;
-  int len_per_transfer = 64;
-  address = address / 2; // Word addressing for Flash
+  const int len_per_transfer = 64;
+  uint8_t word_size = get_flash_word_size();
+  uint16_t faddr = address / word_size; // Word addressing for Flash
+  bool loader_staged = false;
   
-  while (len)
+  while (len > 0)
   {
-    // Prepare Flash-Loader Code in RAM
-    flash_opcode[2] = (address >> 8) & 0xff;
-    flash_opcode[5] = address & 0xff;
-    flash_opcode[13] = (len > len_per_transfer) ? (len_per_transfer / 2) : (len / 2);
-    
-    write_xdata_memory(0xf000, len_per_transfer, &buffer[position]);
-    write_xdata_memory(0xf100, sizeof(flash_opcode), flash_opcode);
+    uint32_t block_start = micros();
+
+    // A partial last word is padded with 0xFF (= unprogrammed)
+    uint8_t block[len_per_transfer];
+    uint8_t count = (len > len_per_transfer) ? len_per_transfer : len;
+    uint8_t padded = (count + word_size - 1) / word_size * word_size;
+    memset(block, 0xFF, sizeof(block));
+    memcpy(block, &buffer[position], count);
+
+    if (!stage_flash_block(faddr, padded / 2, block, loader_staged))
+    {
+      if (_callback != nullptr) _callback(0);
+      return 1; // Block could not be transferred intact
+    }
     
     opcode(0x75, 0xC7, 0x51); // MEMCTR
     set_pc(0xf100);
@@ -255,24 +354,30 @@ uint8_t CC_interface::write_code_memory(uint16_t address, uint8_t buffer[], int
     
     // Safe Timeout for Execution
     unsigned long start = millis();
+    uint32_t wait_start = micros();
     while (!(send_cc_cmdS(0x34) & 0x08)) // Wait for CPU Idle (0x08 in Status byte)
     {
       if (millis() - start > 500)
       {
+        linkMetrics.timeouts++;
         if (_callback != nullptr) _callback(0);
         return 1; // Timeout during write
       }
     }
+    uint32_t now = micros();
+    metricsObserveOp(OP_IDLE_WAIT, now - wait_start);
+    metricsObserveOp(OP_FLASH_BLOCK, now - block_start);
     
+    len -= count;
+    position += count;
+    faddr += padded / word_size;
+
     if (_callback != nullptr)
     {
       uint8_t percent = 100 - ((float)((float)len / (float)entry_len) * 100.0);
       if (percent > 100) percent = 100;
       _callback(percent);
     }
-    len -= flash_opcode[13] * 2;
-    position += flash_opcode[13] * 2;
-    address += flash_opcode[13];
   }
   
   if (_callback != nullptr)
@@ -280,6 +385,151 @@ uint8_t CC_interface::write_code_memory(uint16_t address, uint8_t buffer[], int
   return 0;
 }
 
+// Copies one block and the loader to RAM and checks both with the target-side
+// checksum before the loader may run, so a corrupted frame never reaches the
+// flash. The loader itself is only transferred once, later blocks patch the
+// address and length bytes.
+bool CC_interface::stage_flash_block(uint16_t faddr, uint8_t pairs, uint8_t data[], bool &loader_staged)
+{
+  flash_opcode[2] = (faddr >> 8) & 0xff;
+  flash_opcode[5] = faddr & 0xff;
+  flash_opcode[13] = pairs; // Loader moves two bytes per loop
+
+  for (uint8_t attempt = 0;; attempt++)
+  {
+    write_xdata_memory(0xf000, pairs * 2, data);
+    if (loader_staged)
+    {
+      write_xdata_memory(0xf102, 1, &flash_opcode[2]);
+      write_xdata_memory(0xf105, 1, &flash_opcode[5]);
+      write_xdata_memory(0xf10d, 1, &flash_opcode[13]);
+    }
+    else
+    {
+      write_xdata_memory(0xf100, sizeof(flash_opcode), flash_opcode);
+    }
+
+    uint16_t sum_data, sum_loader;
+    if (checksum_memory(false, 0xf000, pairs * 2, sum_data) && sum_data == host_checksum(data, pairs * 2) &&
+        checksum_memory(false, 0xf100, sizeof(flash_opcode), sum_loader) && sum_loader == host_checksum(flash_opcode, sizeof(flash_opcode)))
+    {
+      loader_staged = true;
+      return true;
+    }
+
+    loader_staged = false; // Transfer everything again
+    if (attempt >= LINK_RETRIES) return false;
+    link_retry();
+  }
+}
+
+// Selects the flash bank of a physical address and returns its address in the 8051 code space
+uint16_t CC_interface::map_code_bank(uint32_t address)
+{
+  // 1. Bank berechnen (32KB Blöcke)
+  // Bank 0: 0x00000 - 0x07FFF (Physikalisch)
+  // Bank 1: 0x08000 - 0x0FFFF (Physikalisch) -> Mapped auf 0x8000
+  // Bank 2: 0x10000 - 0x17FFF (Physikalisch) -> Mapped auf 0x8000
+  // ...
+  uint8_t bank = address / 32768;      // Ganzzahl-Division durch 32k
+  uint16_t offset = address % 32768;   // Rest ist der Offset im 32k Block
+
+  if (bank == 0) {
+    // Bank 0 liegt beim 8051 immer fest im unteren Bereich (0x0000 - 0x7FFF)
+    // Wir müssen MEMCTR hier nicht zwingend setzen, da Bank 0 immer sichtbar ist,
+    // aber wir setzen MEMCTR auf 1, damit der obere Bereich definiert ist (Best Practice)
+    opcode(0x75, 0xC7, 0x01); 
+    return offset;
+  }
+
+  // Alle anderen Banks (1-7) werden in das obere Fenster (0x8000 - 0xFFFF) eingeblendet
+  // Bank auswählen: MOV MEMCTR, #bank
+  // Opcode 0x75 = MOV direct, #data. 0xC7 = Adresse von MEMCTR.
+  opcode(0x75, 0xC7, bank); 
+  return 0x8000 + offset;
+}
+
+// 16-bit sum, same as checksum_opcode computes on the target
+uint16_t CC_interface::host_checksum(const uint8_t buffer[], uint16_t len)
+{
+  uint16_t sum = 0;
+  for (uint16_t i = 0; i < len; i++)
+    sum += buffer[i];
+  return sum;
+}
+
+// Runs checksum_opcode from RAM over code (MOVC) or XDATA (MOVX) memory.
+// A single flipped bit on the link changes the sum, so comparing it with the
+// data the host sent or received detects a corrupted transfer. For code memory
+// the bank has to be mapped already (map_code_bank).
+bool CC_interface::checksum_memory(bool code, uint16_t address, uint16_t len, uint16_t &sum)
+{
+  if (len == 0)
+  {
+    sum = 0;
+    return true;
+  }
+  uint8_t fetch = code ? 0x93 : 0xE0; // MOVC A, @A+DPTR / MOVX A, @DPTR
+  if (!_checksum_staged || checksum_opcode[5] != fetch)
+  {
+    checksum_opcode[5] = fetch;
+    write_xdata_memory(0xf200, sizeof(checksum_opcode), checksum_opcode);
+    _checksum_staged = true;
+  }
+
+  opcode(0x90, address >> 8, address); // MOV DPTR, #address
+  opcode(0x7E, len >> 8);              // MOV R6, #len_hi
+  opcode(0x7F, len & 0xff);            // MOV R7, #len_lo
+  set_pc(0xf200);
+  send_cc_cmdS(0x4c); // Resume Execution
+
+  unsigned long start = millis();
+  while (!(send_cc_cmdS(0x34) & 0x08)) // Wait for the breakpoint at the end
+  {
+    if (millis() - start > 100)
+    {
+      // Routine was probably corrupted: stop the CPU and transfer it again next time
+      linkMetrics.timeouts++;
+      send_cc_cmdS(0x44); // HALT
+      _checksum_staged = false;
+      return false;
+    }
+  }
+  sum = (opcode(0xEA) << 8) | opcode(0xEB); // MOV A, R2 / MOV A, R3
+  return true;
+}
+
+// read_code_memory() with a target-side checksum per chunk. A mismatch is
+// retried at a lower link speed, returns 1 if the chunk stays inconsistent.
+uint8_t CC_interface::read_code_memory_checked(uint32_t address, uint16_t len, uint8_t buffer[])
+{
+  for (uint8_t attempt = 0;; attempt++)
+  {
+    read_code_memory(address, len, buffer);
+    uint16_t sum;
+    if (checksum_memory(true, map_code_bank(address), len, sum) && sum == host_checksum(buffer, len))
+      return 0;
+    if (attempt >= LINK_RETRIES)
+      return 1;
+    link_retry();
+  }
+}
+
+// A transfer was corrupted: count it and halve the link speed (down to 1/8)
+void CC_interface::link_retry()
+{
+  linkMetrics.retries++;
+  if (_clk_delay_us == 0)
+    _clk_delay_us = 1;
+  else if (_clk_delay_us < _base_clk_delay_us * 8 && _clk_delay_us < 128)
+    _clk_delay_us *= 2;
+}
+
+void CC_interface::reset_link_speed()
+{
+  _clk_delay_us = _base_clk_delay_us;
+}
+
 uint8_t CC_interface::verify_code_memory(uint16_t address, uint8_t buffer[], int len)
 {
   int last_callback = 0;
@@ -312,56 +562,72 @@ uint8_t CC_interface::verify_code_memory(uint16_t address, uint8_t buffer[], int
 
 uint8_t CC_interface::opcode(uint8_t opCode)
 {
-  cc_send_byte(0x55);
-  cc_send_byte(opCode);
-  return cc_receive_byte();
+  OpTimer timer(OP_OPCODE);
+  linkMetrics.instrFrames++;
+  uint8_t frame[2] = { 0x55, opCode };
+  return transfer(frame, 2, 1);
 }
 
 uint8_t CC_interface::opcode(uint8_t opCode, uint8_t opCode1)
 {
-  cc_send_byte(0x56);
-  cc_send_byte(opCode);
-  cc_send_byte(opCode1);
-  return cc_receive_byte();
+  OpTimer timer(OP_OPCODE);
+  linkMetrics.instrFrames++;
+  uint8_t frame[3] = { 0x56, opCode, opCode1 };
+  return transfer(frame, 3, 1);
 }
 
 uint8_t CC_interface::opcode(uint8_t opCode, uint8_t opCode1, uint8_t opCode2)
 {
-  cc_send_byte(0x57);
-  cc_send_byte(opCode);
-  cc_send_byte(opCode1);
-  cc_send_byte(opCode2);
-  return cc_receive_byte();
+  OpTimer timer(OP_OPCODE);
+  linkMetrics.instrFrames++;
+  uint8_t frame[4] = { 0x57, opCode, opCode1, opCode2 };
+  return transfer(frame, 4, 1);
 }
 
 uint8_t CC_interface::WR_CONFIG(uint8_t config)
 {
-  cc_send_byte(0x1d);
-  cc_send_byte(config);
-  return cc_receive_byte();
+  linkMetrics.cmdFrames++;
+  uint8_t frame[2] = { 0x1d, config };
+  return transfer(frame, 2, 1);
 }
 
 uint8_t CC_interface::WD_CONFIG()
 {
-  cc_send_byte(0x24);
-  return cc_receive_byte();
+  linkMetrics.cmdFrames++;
+  uint8_t frame[1] = { 0x24 };
+  return transfer(frame, 1, 1);
 }
 
 uint8_t CC_interface::send_cc_cmdS(uint8_t cmd)
 {
-  cc_send_byte(cmd);
-  return cc_receive_byte();
+  linkMetrics.cmdFrames++;
+  return transfer(&cmd, 1, 1);
 }
 
 uint16_t CC_interface::send_cc_cmd(uint8_t cmd)
 {
-  cc_send_byte(cmd);
-  return (cc_receive_byte() << 8) + cc_receive_byte();
+  linkMetrics.cmdFrames++;
+  return transfer(&cmd, 1, 2);
+}
+
+// One frame on the link: command (+ instruction bytes) out, 1-2 response bytes in
+uint16_t CC_interface::transfer(const uint8_t* frame, uint8_t len, uint8_t rxLen)
+{
+  uint32_t start = traceEnabled ? ESP.getCycleCount() : 0;
+  for (uint8_t i = 0; i < len; i++)
+    cc_send_byte(frame[i]);
+  uint16_t answer = cc_receive_byte();
+  if (rxLen == 2)
+    answer = (answer << 8) | cc_receive_byte();
+  if (traceEnabled)
+    traceRecord(start, frame, len, answer, rxLen);
+  return answer;
 }
 
 // Atomic Bit-Banging (Disable Interrupts)
 void CC_interface::cc_send_byte(uint8_t in_byte)
 {
+  linkMetrics.bytesTx++;
   if (dd_direction == 1)
   {
     dd_direction = 0;
@@ -382,7 +648,7 @@ void CC_interface::cc_send_byte(uint8_t in_byte)
 
     digitalWrite(_CC_PIN, HIGH);
     in_byte <<= 1;
-    delayMicroseconds(5);
+    delayMicroseconds(_clk_delay_us);
     digitalWrite(_CC_PIN, LOW);
   }
   
@@ -394,6 +660,7 @@ void CC_interface::cc_send_byte(uint8_t in_byte)
 uint8_t CC_interface::cc_receive_byte()
 {
   uint8_t out_byte = 0x00;
+  linkMetrics.bytesRx++;
   if (dd_direction == 0)
   {
     dd_direction = 1;
@@ -407,12 +674,12 @@ uint8_t CC_interface::cc_receive_byte()
   for (int i = 8; i; i--)
   {
     digitalWrite(_CC_PIN, HIGH);
-    delayMicroseconds(5);
+    delayMicroseconds(_clk_delay_us);
     out_byte <<= 1;
     if (digitalRead(_DD_PIN))
       out_byte |= 0x01;
     digitalWrite(_CC_PIN, LOW);
-    delayMicroseconds(5);
+    delayMicroseconds(_clk_delay_us);
   }
   
   interrupts();
@@ -426,6 +693,7 @@ void CC_interface::enable_cc_debug()
   // This sequence is based on RedBearLab/CCLoader and is known to be
   // more compatible with CC2531 USB dongles.
   // The key is a fast TWO-PULSE sequence on DC while RESET is low.
+  _checksum_staged = false; // RAM content is lost
   digitalWrite(_RESET_PIN, LOW);
   delay(2); // Wait for reset to settle
   
@@ -442,10 +710,12 @@ void CC_interface::enable_cc_debug()
   
   digitalWrite(_RESET_PIN, HIGH);
   delay(2); // Wait for chip to wake up
+  if (_reset_hook != nullptr) _reset_hook();
 }
 
 void CC_interface::reset_cc()
 {
+  _checksum_staged = false;
   if (dd_direction == 0)
   {
     dd_direction = 1;
@@ -475,6 +745,7 @@ uint32_t CC_interface::detect_flash_size() {
     // FIX: Retry mechanism. If ID is 0x00 or 0xFF, communication might be unstable.
     if (raw_id == 0x0000 || raw_id == 0xFFFF) {
         // Try a quick re-init sequence (NOP) and read again
+        linkMetrics.retries++;
         opcode(0x00); 
         delay(10);
         raw_id = send_cc_cmd(0x68);
@@ -525,6 +796,25 @@ uint32_t CC_interface::detect_flash_size() {
     return max_size; 
 }
 
+// Flash word (unit of FADDR): 4 bytes on CC253x, 2 bytes on CC111x.
+// A 16-bit word address reaches 256 KB resp. 128 KB.
+bool CC_interface::is_cc253x() {
+    uint8_t chip_id = (send_cc_cmd(0x68) >> 8) & 0xFF; // GET_CHIP_ID
+    return chip_id == 0xA5 || chip_id == 0xB5;
+}
+
+uint8_t CC_interface::get_flash_word_size() {
+    return is_cc253x() ? 4 : 2;
+}
+
+// CC253x uses 2KB Flash Pages, CC111x 1KB
+uint16_t CC_interface::get_flash_page_size() {
+    if (is_cc253x()) {
+        return 2048;
+    }
+    return 1024;
+}
+
 void CC_interface::debug_halt()
 {
   // Halt command (same as enable_cc_debug sequence)
@@ -555,6 +845,18 @@ uint8_t CC_interface::get_status_byte()
   return send_cc_cmdS(0x34);
 }
 
+uint8_t CC_interface::debug_break()
+{
+  // 0x44 = CMD_HALT
+  return send_cc_cmdS(0x44);
+}
+
+uint8_t CC_interface::debug_continue()
+{
+  // 0x4C = CMD_RESUME
+  return send_cc_cmdS(0x4C);
+}
+
 // Read SFR (Special Function Register)
 // Trick: We inject "MOV A, sfrAddr" -> "MOV DPTR, 0xF000" -> "MOVX @DPTR, A"
 uint8_t CC_interface::read_sfr(uint8_t sfr_addr) {
@@ -573,71 +875,128 @@ uint8_t CC_interface::read_sfr(uint8_t sfr_addr) {
     return val;
 }
 
-void CC_interface::set_hw_breakpoint(uint16_t address)
+uint8_t CC_interface::write_hw_breakpoint(uint8_t index, uint32_t address, bool enable)
 {
-  // 1. Write Breakpoint Addr to Debug Registers (XDATA Mapped)
-  // CC Chips usually use 0xC760 (Low) and 0xC761 (High) for BP0
-  uint8_t bp_low = address & 0xFF;
-  uint8_t bp_high = (address >> 8) & 0xFF;
-  
-  uint8_t data[2] = { bp_low, bp_high };
-  write_xdata_memory(0xC760, 2, data);
+  // 0x3F = CMD_SET_HW_BRKPNT: [number (4:3) | enable (2) | address 17:16], address high, address low
+  linkMetrics.cmdFrames++;
+  uint8_t frame[4] = { 0x3F, (uint8_t)(((index & 0x03) << 3) | (enable ? 0x04 : 0) | ((address >> 16) & 0x03)),
+                       (uint8_t)(address >> 8), (uint8_t)address };
+  return transfer(frame, 4, 1);
+}
 
-  // 2. Enable Breakpoint (Control Register 0xC768, Bit 0 = Enable BP0)
-  uint8_t ctrl = 0x01; // Enable BP0
-  write_xdata_memory(0xC768, 1, &ctrl);
+// Reads the Program Counter
+uint16_t CC_interface::read_pc() {
+    // 0x28 = CMD_GET_PC (answer: PC high, low). Unlike an injected LCALL this
+    // leaves stack, A, R0, DPTR and the XDATA scratchpad untouched.
+    return send_cc_cmd(0x28);
 }
 
-void CC_interface::disable_hw_breakpoint()
+// Reads R0-R7 based on the current Register Bank
+void CC_interface::read_idata_memory(uint8_t address, uint16_t len, uint8_t buffer[])
 {
-  // Disable BP0 (Bit 0 to 0)
-  uint8_t ctrl = 0x00;
-  write_xdata_memory(0xC768, 1, &ctrl);
+  uint8_t acc = opcode(0xE5, 0xE0);           // MOV A, ACC (DEBUG_INSTR returns A)
+  uint8_t r0 = opcode(0xE5, 0xD0) & 0x18;     // MOV A, PSW -> direct address of R0 in the active bank
+  uint8_t r0_val = opcode(0xE5, r0);          // MOV A, R0
+  for (uint16_t i = 0; i < len; i++)
+  {
+    uint8_t addr = address + i;
+    if (addr < 0x80)
+    {
+      buffer[i] = opcode(0xE5, addr);         // MOV A, direct
+    }
+    else
+    {
+      opcode(0x78, addr);                     // MOV R0, #addr (upper 128 bytes: indirect only)
+      buffer[i] = opcode(0xE6);               // MOV A, @R0
+    }
+  }
+  opcode(0x78, r0_val);                       // MOV R0, #saved
+  opcode(0x74, acc);                          // MOV A, #saved
 }
 
-// Reads the Program Counter via Stack-Trick (Non-destructive)
-uint16_t CC_interface::read_pc() {
-    // 1. Save Stack Pointer (SP)
-    uint8_t sp_orig = read_sfr(0x81); 
-
-    // 2. Inject LCALL 0xF000. 
-    // This pushes the current PC onto the stack and sets PC to 0xF000.
-    opcode(0x12, 0xF0, 0x00); 
-
-    // Helper Variable
-    uint8_t pc_parts[2] = {0, 0}; // [0]=High, [1]=Low
-
-    // 3. Retrieve original PC from Internal Stack (IDATA)
-    // High Byte is at SP+2, Low Byte at SP+1
-    for(int i=0; i<2; i++) {
-        uint8_t target_idata_addr = sp_orig + 2 - i; 
-        
-        // A) Move IDATA value to R0
-        opcode(0x78, target_idata_addr); // MOV R0, #addr
-        
-        // B) Move value from IDATA (@R0) to Accumulator (A)
-        opcode(0xE6); // MOV A, @R0 
-        
-        // C) Move A to XDATA 0xF000 (our scratchpad)
-        opcode(0x90, 0xF0, 0x00); // MOV DPTR, #0xF000
-        opcode(0xF0);             // MOVX @DPTR, A
-        
-        // D) Read from XDATA
-        read_xdata_memory(0xF000, 1, &pc_parts[i]);
+void CC_interface::read_sfr_memory(uint8_t address, uint16_t len, uint8_t buffer[])
+{
+  uint8_t acc = opcode(0xE5, 0xE0);           // MOV A, ACC
+  for (uint16_t i = 0; i < len; i++)
+  {
+    uint8_t sfr = address + i;
+    buffer[i] = (sfr == 0xE0) ? acc : opcode(0xE5, sfr); // MOV A, direct (direct >= 0x80 = SFR)
+  }
+  opcode(0x74, acc);                          // MOV A, #saved
+}
+
+void CC_interface::read_sfrs(const uint8_t sfrs[], uint8_t count, uint8_t buffer[])
+{
+  uint8_t acc = opcode(0xE5, 0xE0);           // MOV A, ACC
+  for (uint8_t i = 0; i < count; i++)
+    buffer[i] = (sfrs[i] == 0xE0) ? acc : opcode(0xE5, sfrs[i]);
+  opcode(0x74, acc);                          // MOV A, #saved
+}
+
+void CC_interface::write_idata_memory(uint8_t address, uint16_t len, const uint8_t buffer[])
+{
+  uint8_t acc = opcode(0xE5, 0xE0);           // MOV A, ACC
+  uint8_t r0 = opcode(0xE5, 0xD0) & 0x18;     // MOV A, PSW -> R0 of the active bank
+  uint8_t r0_val = opcode(0xE5, r0);          // MOV A, R0
+  for (uint16_t i = 0; i < len; i++)
+  {
+    uint8_t addr = address + i;
+    if (addr == r0) r0_val = buffer[i];       // R0 itself: written by the restore below
+    if (addr < 0x80)
+    {
+      opcode(0x75, addr, buffer[i]);          // MOV direct, #data
+    }
+    else
+    {
+      opcode(0x78, addr);                     // MOV R0, #addr
+      opcode(0x76, buffer[i]);                // MOV @R0, #data
     }
+  }
+  opcode(0x78, r0_val);                       // MOV R0, #saved
+  opcode(0x74, acc);                          // MOV A, #saved
+}
 
-    // 4. Restore Stack Pointer
-    opcode(0x75, 0x81, sp_orig); // MOV SP, #orig
+void CC_interface::write_sfr_memory(uint8_t address, uint16_t len, const uint8_t buffer[])
+{
+  for (uint16_t i = 0; i < len; i++)
+    opcode(0x75, (uint8_t)(address + i), buffer[i]); // MOV direct, #data
+}
 
-    // 5. RESTORE PROGRAM COUNTER (The Fix!)
-    // We must jump back to where we came from, otherwise PC stays at 0xF000.
-    // Opcode 0x02 = LJMP (Long Jump)
-    opcode(0x02, pc_parts[0], pc_parts[1]);
+// MOV DPTR / MOVX @DPTR act on the pointer DPS selects, so that pair is saved
+uint8_t CC_interface::active_dpl()
+{
+  return (opcode(0xE5, 0x92) & 0x01) ? 0x84 : 0x82; // MOV A, DPS
+}
 
-    return (uint16_t)(pc_parts[0] << 8) | pc_parts[1];
+void CC_interface::peek_code(uint32_t address, uint16_t len, uint8_t buffer[])
+{
+  uint8_t acc = opcode(0xE5, 0xE0);           // MOV A, ACC
+  uint8_t dp = active_dpl();
+  uint8_t dpl = opcode(0xE5, dp);             // MOV A, DPL
+  uint8_t dph = opcode(0xE5, dp + 1);         // MOV A, DPH
+  uint8_t memctr = opcode(0xE5, 0xC7);        // MOV A, MEMCTR
+  read_code_memory(address, len, buffer);     // Maps the bank itself
+  opcode(0x75, 0xC7, memctr);                 // MOV MEMCTR, #saved
+  opcode(0x90, dph, dpl);                     // MOV DPTR, #saved
+  opcode(0x74, acc);                          // MOV A, #saved
+}
+
+void CC_interface::read_code_mapped(uint16_t address, uint8_t len, uint8_t buffer[])
+{
+  uint8_t acc = opcode(0xE5, 0xE0);           // MOV A, ACC
+  uint8_t dp = active_dpl();
+  uint8_t dpl = opcode(0xE5, dp);             // MOV A, DPL
+  uint8_t dph = opcode(0xE5, dp + 1);         // MOV A, DPH
+  opcode(0x90, address >> 8, address);        // MOV DPTR, #address
+  for (uint8_t i = 0; i < len; i++)
+  {
+    opcode(0x74, i);                          // MOV A, #i
+    buffer[i] = opcode(0x93);                 // MOVC A, @A+DPTR
+  }
+  opcode(0x90, dph, dpl);                     // MOV DPTR, #saved
+  opcode(0x74, acc);                          // MOV A, #saved
 }
 
-// Reads R0-R7 based on the current Register Bank
 void CC_interface::read_r0_r7(uint8_t* buffer) {
     uint8_t psw = read_sfr(0xD0);     // Read PSW
     uint8_t bank = (psw >> 3) & 0x03; // Bits 3 and 4 are Bank Select
@@ -2,6 +2,17 @@
 #include <Arduino.h>
 
 typedef void (*callbackPtr)(uint8_t percent);
+typedef void (*resetHookPtr)();
+
+// Attempts per chunk after a checksum mismatch on the debug link
+#define LINK_RETRIES 3
+
+enum PeekSpace : uint8_t { PEEK_XDATA, PEEK_IDATA, PEEK_SFR };
+struct PeekItem {
+    uint8_t space;   // PeekSpace
+    uint8_t len;
+    uint16_t address;
+};
 
 class CC_interface
 {
@@ -17,6 +28,10 @@ class CC_interface
     
     // Set a callback function for progress updates (0-100%)
     void set_callback(callbackPtr callBack = nullptr);
+
+    // Called after every reset into debug mode (enable_cc_debug, debug_halt):
+    // state the reset lost, like the breakpoint comparators, is written again
+    void set_reset_hook(resetHookPtr hook);
     
     // Set the Lock Byte (Read Protection)
     uint8_t set_lock_byte(uint8_t lock_byte);
@@ -24,17 +39,53 @@ class CC_interface
     // Perform a full Chip Erase (Unlocks the chip)
     uint8_t erase_chip();
     
+    // Erase a single Flash Page (address = byte address inside the page)
+    uint8_t erase_page(uint32_t address);
+    
     // --- Memory Access ---
     void read_code_memory(uint32_t address, uint16_t len, uint8_t buffer[]);
     void read_xdata_memory(uint16_t address, uint16_t len, uint8_t buffer[]);
+    // Same for a stopped program: A and DPTR are restored (debugger reads)
+    void peek_xdata(uint16_t address, uint16_t len, uint8_t buffer[]);
     void write_xdata_memory(uint16_t address, uint16_t len, uint8_t buffer[]);
+    // DATA/IDATA (0x00-0xFF) and SFR space (0x80-0xFF) through debug instructions,
+    // independent of the chip's XDATA mapping. A and R0 are restored afterwards.
+    void read_idata_memory(uint8_t address, uint16_t len, uint8_t buffer[]);
+    void read_sfr_memory(uint8_t address, uint16_t len, uint8_t buffer[]);
+    void read_sfrs(const uint8_t sfrs[], uint8_t count, uint8_t buffer[]); // Scattered SFRs, one frame each
+    void write_idata_memory(uint8_t address, uint16_t len, const uint8_t buffer[]);
+    void write_sfr_memory(uint8_t address, uint16_t len, const uint8_t buffer[]);
+    // Flat code address like read_code_memory() for a stopped program: A, DPTR
+    // and MEMCTR (code bank) are restored afterwards
+    void peek_code(uint32_t address, uint16_t len, uint8_t buffer[]);
+    // Code bytes as the CPU sees them (current MEMCTR bank), A and DPTR restored
+    void read_code_mapped(uint16_t address, uint8_t len, uint8_t buffer[]);
+    // Several variables of a stopped program in one pass: A, DPTR and R0 are
+    // saved once for the whole list and only when an item needs them
+    void peek_batch(const PeekItem items[], uint8_t count, uint8_t buffer[]);
     
     // --- Core Functions ---
     void set_pc(uint16_t address);
     uint8_t clock_init(); // Initialize Debug Clock
     
+    // Debug Clock half-period in microseconds (link speed, default 5)
+    void set_clock_delay(uint8_t us);
+    uint8_t get_clock_delay();
+    
     // Write firmware to Flash (Code Memory)
-    uint8_t write_code_memory(uint16_t address, uint8_t buffer[], int len);
+    uint8_t write_code_memory(uint32_t address, uint8_t buffer[], int len);
+    
+    // Read with link check: every chunk is compared against a checksum the
+    // target computes itself, mismatches are retried at a lower link speed.
+    // Returns: 0 = OK, 1 = chunk still corrupted after LINK_RETRIES
+    uint8_t read_code_memory_checked(uint32_t address, uint16_t len, uint8_t buffer[]);
+    
+    // 16-bit byte sum of code (bank must be mapped) or XDATA memory, computed on the target
+    bool checksum_memory(bool code, uint16_t address, uint16_t len, uint16_t &sum);
+    static uint16_t host_checksum(const uint8_t buffer[], uint16_t len);
+    
+    // Link speed after a corrupted transfer (reset at the start of every job)
+    void reset_link_speed();
     
     // Verify firmware against buffer
     uint8_t verify_code_memory(uint16_t address, uint8_t buffer[], int len);
@@ -49,19 +100,24 @@ class CC_interface
     // --- Info & Detection ---
     uint8_t read_chip_info_byte(uint16_t offset);
     uint32_t detect_flash_size();
+    uint16_t get_flash_page_size(); // Erase granularity in bytes
+    uint8_t get_flash_word_size();  // Write granularity / FADDR unit in bytes
+    bool is_cc253x();               // CC253x: 32 KB code banks above 0x8000 (MEMCTR)
     
     // --- DEBUGGER FUNCTIONS ---
     void debug_halt();             // Halt the CPU
     void debug_resume();           // Resume execution
     void debug_step();             // Execute single instruction
     uint8_t get_status_byte();     // Read Debug Status Register
+    uint8_t debug_break();         // CMD_HALT: stop the running CPU in place (debug_halt resets into debug mode), returns status
+    uint8_t debug_continue();      // CMD_RESUME without the settle delays of debug_resume (samplers), returns status
     uint8_t read_sfr(uint8_t sfr_addr); // Read Special Function Register
-    uint16_t read_pc();            // Read Program Counter
+    uint16_t read_pc();            // Read Program Counter (GET_PC, no side effects)
     void read_r0_r7(uint8_t* buffer);   // Read current Register Bank (R0-R7)
     
     // Hardware Breakpoints
-    void set_hw_breakpoint(uint16_t address);
-    void disable_hw_breakpoint();
+    // SET_HW_BRKPNT for comparator 0-3, address = flat code address (bank in bits 17:16)
+    uint8_t write_hw_breakpoint(uint8_t index, uint32_t address, bool enable);
     // -------------------------
 
     /* Send one byte and return one byte as answer */
@@ -75,10 +131,19 @@ class CC_interface
     void reset_cc();
 
   private:
+    uint16_t transfer(const uint8_t* frame, uint8_t len, uint8_t rxLen);
+    uint16_t map_code_bank(uint32_t address);
+    bool stage_flash_block(uint16_t faddr, uint8_t pairs, uint8_t data[], bool &loader_staged);
+    void link_retry();
+    uint8_t active_dpl(); // DPL of the data pointer selected by DPS: 0x82 (DPTR0) or 0x84 (DPTR1)
+
     boolean dd_direction = 0; // 0=OUT 1=IN
     uint8_t _CC_PIN = -1;
     uint8_t _DD_PIN = -1;
     uint8_t _RESET_PIN = -1;
+    uint8_t _clk_delay_us = 5;
+    uint8_t _base_clk_delay_us = 5;
+    bool _checksum_staged = false;
     
     // Flash Loader Code (8051 Assembly machine code injected into RAM)
     // This small program moves data from RAM (0xF000) to Flash Controller.
@@ -99,7 +164,29 @@ class CC_interface
       0xDD, 0xF1,       // DJNZ R5, Loop     ; Decrease count and loop
       0xA5              // DB   0xA5         ; Breakpoint / Done
     };
+    // Checksum routine (0xF200): R2:R3 = sum of R6:R7 bytes starting at DPTR
+    uint8_t checksum_opcode[22] = {
+      0x7A, 0x00,       // MOV  R2, #00      ; Sum High
+      0x7B, 0x00,       // MOV  R3, #00      ; Sum Low
+      0xE4,             // CLR  A            ; Loop:
+      0x93,             // MOVC A, @A+DPTR   ; Load byte (patched: 0xE0 = MOVX A, @DPTR)
+      0x2B,             // ADD  A, R3
+      0xFB,             // MOV  R3, A
+      0xE4,             // CLR  A
+      0x3A,             // ADDC A, R2
+      0xFA,             // MOV  R2, A
+      0xA3,             // INC  DPTR
+      0xEF,             // MOV  A, R7        ; 16-bit decrement of R6:R7
+      0x70, 0x01,       // JNZ  +1
+      0x1E,             // DEC  R6
+      0x1F,             // DEC  R7
+      0xEF,             // MOV  A, R7
+      0x4E,             // ORL  A, R6
+      0x70, 0xEF,       // JNZ  Loop
+      0xA5              // DB   0xA5         ; Breakpoint / Done
+    };
     callbackPtr _callback = nullptr;
+    resetHookPtr _reset_hook = nullptr;
 };
 
 extern CC_interface cc;
\ No newline at end of file
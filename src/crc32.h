@@ -0,0 +1,12 @@
+#pragma once
+#include <Arduino.h>
+
+// CRC-32 (IEEE 802.3, reflected). Pass the previous result to continue a running checksum.
+inline uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    while(len--) {
+        crc ^= *data++;
+        for(int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
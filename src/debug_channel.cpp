@@ -0,0 +1,166 @@
+#include "debug_channel.h"
+#include "cc_interface.h"
+#include "flasher_controller.h"
+#include "run_control.h"
+#include "breakpoints.h"
+
+// Snapshot SFRs in wire order (ACC B PSW SP DPL DPH P0 P1 P2)
+static const uint8_t SNAPSHOT_SFRS[] = { 0xE0, 0xF0, 0xD0, 0x81, 0x82, 0x83, 0x80, 0x90, 0xA0 };
+
+size_t readSnapshot(uint8_t* out) {
+    out[0] = cc.get_status_byte();
+    if(!cpuHalted(out[0])) return 1;
+    uint16_t pc = cc.read_pc();
+    out[1] = pc & 0xFF;
+    out[2] = pc >> 8;
+    cc.read_sfrs(SNAPSHOT_SFRS, sizeof(SNAPSHOT_SFRS), out + 3);
+    cc.read_idata_memory(out[5] & 0x18, 8, out + 12); // Bank from PSW
+    return DBG_SNAPSHOT_SIZE;
+}
+
+void readTargetMemory(uint8_t space, uint32_t addr, uint16_t len, uint8_t* buf) {
+    switch(space) {
+        case MEM_CODE:  cc.peek_code(addr, len, buf); break;
+        case MEM_IDATA: cc.read_idata_memory(addr, len, buf); break;
+        case MEM_SFR:   cc.read_sfr_memory(addr, len, buf); break;
+        default:        cc.peek_xdata(addr, len, buf); break;
+    }
+}
+
+// Address range inside a space
+static bool inSpace(uint8_t space, uint32_t addr, uint32_t len) {
+    switch(space) {
+        case MEM_XDATA:
+        case MEM_CODE:  return addr + len <= 0x10000;
+        case MEM_IDATA: return addr + len <= 0x100;
+        case MEM_SFR:   return addr >= 0x80 && addr + len <= 0x100;
+        default:        return false;
+    }
+}
+
+static uint8_t execute(uint8_t op, const uint8_t* p, size_t len, uint8_t* out, size_t &outLen) {
+    // Any other control command ends a step over/out that is still running
+    if(op == DBG_OP_HALT || op == DBG_OP_RESUME || op == DBG_OP_STEP) runControlDisarm();
+    switch(op) {
+        case DBG_OP_STATUS:
+            out[0] = cc.get_status_byte();
+            outLen = 1;
+            return DBG_OK;
+
+        case DBG_OP_HALT:
+            cc.debug_halt(); // Comparators written again by the reset hook (bpRestore)
+            bpNoteStop();
+            outLen = readSnapshot(out);
+            return DBG_OK;
+
+        case DBG_OP_RESUME:
+            bpNoteResume();
+            cc.debug_resume();
+            out[0] = cc.get_status_byte();
+            outLen = 1;
+            return DBG_OK;
+
+        case DBG_OP_STEP: {
+            uint16_t count = (len >= 2) ? (p[0] | (p[1] << 8)) : 1;
+            if(count == 0 || count > DBG_MAX_STEPS) return DBG_BAD_REQUEST;
+            bpNoteStop();
+            for(uint16_t i = 0; i < count; i++) cc.debug_step();
+            outLen = readSnapshot(out);
+            return DBG_OK;
+        }
+
+        case DBG_OP_REGS:
+            outLen = readSnapshot(out);
+            return DBG_OK;
+
+        case DBG_OP_READ: {
+            if(len < 5) return DBG_BAD_REQUEST;
+            uint16_t addr = p[1] | (p[2] << 8);
+            uint16_t n = p[3] | (p[4] << 8);
+            if(n > DBG_MAX_READ || !inSpace(p[0], addr, n)) return DBG_BAD_REQUEST;
+            readTargetMemory(p[0], addr, n, out);
+            outLen = n;
+            return DBG_OK;
+        }
+
+        case DBG_OP_WRITE: {
+            if(len < 3) return DBG_BAD_REQUEST;
+            uint16_t addr = p[1] | (p[2] << 8);
+            uint16_t n = len - 3;
+            if(p[0] == MEM_CODE || !inSpace(p[0], addr, n)) return DBG_BAD_REQUEST;
+            if(p[0] == MEM_IDATA) cc.write_idata_memory(addr, n, p + 3);
+            else if(p[0] == MEM_SFR) cc.write_sfr_memory(addr, n, p + 3);
+            else cc.write_xdata_memory(addr, n, (uint8_t*)(p + 3));
+            return DBG_OK;
+        }
+
+        case DBG_OP_BP_SET: {
+            if(len < 2) return DBG_BAD_REQUEST;
+            BpCondition cond = {};
+            if(len > 3) {
+                char text[BP_COND_TEXT];
+                if(len - 3 >= BP_COND_TEXT) return DBG_BAD_CONDITION;
+                memcpy(text, p + 3, len - 3);
+                text[len - 3] = 0;
+                if(!parseBpCondition(text, cond)) return DBG_BAD_CONDITION;
+            }
+            int16_t bank = (len >= 3 && p[2] != 0xFF) ? p[2] : -1;
+            int8_t n = bpSet(codeAddress(p[0] | (p[1] << 8), bank), &cond);
+            if(n < 0) return DBG_BP_FULL;
+            out[0] = n;
+            outLen = 1;
+            return DBG_OK;
+        }
+
+        case DBG_OP_BP_CLEAR:
+            if(len >= 2) bpClear(codeAddress(p[0] | (p[1] << 8), (len >= 3 && p[2] != 0xFF) ? p[2] : -1));
+            else bpClearAll();
+            return DBG_OK;
+
+        case DBG_OP_BP_LIST: {
+            uint32_t addr[BP_COUNT];
+            uint8_t idx[BP_COUNT];
+            uint8_t n = bpList(addr, idx);
+            for(uint8_t i = 0; i < n; i++) {
+                out[i * 4] = idx[i];
+                out[i * 4 + 1] = addr[i] & 0xFF;
+                out[i * 4 + 2] = (addr[i] >> 8) & 0xFF;
+                out[i * 4 + 3] = addr[i] >> 16;
+            }
+            outLen = n * 4;
+            return DBG_OK;
+        }
+
+        case DBG_OP_STEP_OVER:
+        case DBG_OP_STEP_OUT:
+        case DBG_OP_RUN_TO: {
+            if(op == DBG_OP_RUN_TO && len < 2) return DBG_BAD_REQUEST;
+            if(!cpuHalted(cc.get_status_byte())) return DBG_NOT_HALTED;
+            RunResult r = (op == DBG_OP_STEP_OVER) ? stepOver()
+                        : (op == DBG_OP_STEP_OUT) ? stepOut() : runTo(p[0] | (p[1] << 8));
+            if(r == RUN_NO_RETURN) return DBG_NO_RETURN;
+            if(r == RUN_NO_BREAKPOINT) return DBG_BP_FULL;
+            outLen = readSnapshot(out);
+            return DBG_OK;
+        }
+
+        default:
+            return DBG_UNKNOWN_OP;
+    }
+}
+
+size_t handleDebugRequest(const uint8_t* req, size_t len, uint8_t* resp) {
+    if(len < 2) return 0;
+    resp[0] = req[0];
+    resp[1] = req[1];
+    size_t outLen = 0;
+    if(req[0] == DBG_OP_BP_LIST) {
+        resp[2] = execute(req[0], req + 2, len - 2, resp + 3, outLen); // Cache only, works during jobs
+    } else if(!acquireLink()) {
+        resp[2] = DBG_BUSY;
+    } else {
+        resp[2] = execute(req[0], req + 2, len - 2, resp + 3, outLen);
+        releaseLink();
+    }
+    return 3 + outLen;
+}
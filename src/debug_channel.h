@@ -0,0 +1,59 @@
+#pragma once
+#include <Arduino.h>
+
+// --- DEBUG CHANNEL ---
+// Compact binary debugger protocol, carried over the WebSocket /ws/debug
+// (one request per binary message). Requests may be pipelined: they are
+// executed and answered in the order received, the id pairs them up.
+//   Request:  [op][id][payload...]
+//   Response: [op][id][result][payload...]
+// 16-bit values are little endian. Each request holds the debug link only
+// for its own duration; while a job runs the result is DBG_BUSY.
+
+enum DebugOp : uint8_t {
+    DBG_OP_STATUS   = 0x01, // -> [status]
+    DBG_OP_HALT     = 0x02, // -> snapshot
+    DBG_OP_RESUME   = 0x03, // -> [status]
+    DBG_OP_STEP     = 0x04, // [count u16] (optional, default 1) -> snapshot after the last step
+    DBG_OP_REGS     = 0x05, // -> snapshot
+    DBG_OP_READ     = 0x06, // [space][addr u16][len u16] -> data
+    DBG_OP_WRITE    = 0x07, // [space][addr u16][data...] -> -
+    DBG_OP_BP_SET   = 0x08, // [addr u16][bank][condition text] (optional, bank 0xFF: mapped one) -> [comparator]
+    DBG_OP_BP_CLEAR = 0x09, // [addr u16][bank] (without address: all) -> -
+    DBG_OP_STEP_OVER = 0x0A, // -> snapshot (status alone if the call has not returned yet)
+    DBG_OP_STEP_OUT  = 0x0B, // -> snapshot (same)
+    DBG_OP_RUN_TO    = 0x0C, // [addr u16] -> snapshot (same)
+    DBG_OP_BP_LIST   = 0x0D, // -> [comparator][flat addr u24] per breakpoint (cache, no link traffic)
+
+    // Pushed by the server (id 0): CPU state change seen by the halt watch
+    DBG_EVT_STATE   = 0x80, // -> snapshot
+};
+
+enum DebugResult : uint8_t { DBG_OK, DBG_BUSY, DBG_BAD_REQUEST, DBG_UNKNOWN_OP,
+                             DBG_NOT_HALTED,   // Run control needs a halted CPU
+                             DBG_NO_RETURN,    // Step out: no return address on the stack
+                             DBG_BP_FULL,      // All four comparators in use
+                             DBG_BAD_CONDITION }; // Syntax error in a breakpoint condition (bp_condition.h)
+
+// Address spaces (READ/WRITE, /api/debug/mem.bin). Code is read-only here.
+enum MemSpace : uint8_t { MEM_XDATA, MEM_CODE, MEM_IDATA, MEM_SFR };
+
+// Snapshot: [status][PC u16][ACC][B][PSW][SP][DPL][DPH][P0][P1][P2][R0..R7]
+// (active bank). While the CPU runs it is the status byte alone.
+const size_t DBG_SNAPSHOT_SIZE = 20;
+const uint16_t DBG_MAX_READ = 1024;  // Larger blocks: /api/debug/mem.bin
+const uint16_t DBG_MAX_STEPS = 1000; // Keeps one request well below the async TCP watchdog
+const size_t DBG_RESPONSE_MAX = 3 + DBG_MAX_READ;
+
+// Executes one request, writes the response to resp (DBG_RESPONSE_MAX bytes).
+// Returns the response length, 0 = too short to answer (no id).
+size_t handleDebugRequest(const uint8_t* req, size_t len, uint8_t* resp);
+
+// Status byte of the debug interface -> CPU halted (0xFF = no target/open bus)
+inline bool cpuHalted(uint8_t status) { return (status & 0x20) && status != 0xFF; }
+
+// Register snapshot as above (link must be held). Returns its length.
+size_t readSnapshot(uint8_t* out);
+
+// Reads len bytes of a space, bounds already checked (link must be held)
+void readTargetMemory(uint8_t space, uint32_t addr, uint16_t len, uint8_t* buf);
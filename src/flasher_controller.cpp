@@ -1,16 +1,33 @@
 #include "flasher_controller.h"
 #include "cc_interface.h"
+#include "crc32.h"
+#include "metrics.h"
+#include "link_trace.h"
+#include "image_store.h"
 #include <LittleFS.h>
-#include <freertos/semphr.h>
 
 // --- CONFIGURATION ---
 const uint32_t CHUNK_SIZE = 1024;
+const char* CKPT_PATH = "/flash.ckpt";
+const uint32_t CKPT_MAGIC = 0x43434B33; // "CCK3"
+const char* PRESERVE_PATH = "/preserve.bin";
+const uint8_t PAGE_REPAIR_ATTEMPTS = 3;  // Erase + reprogram per page before a mismatch fails the job
 
 // --- GLOBALS (Internal) ---
-static SemaphoreHandle_t statusMutex;
-static volatile bool isFlashing = false;
-static volatile int globalPercent = 0;
-static String globalStatusMsg = "System ready.";
+static volatile bool isFlashing = false;     // Link owned by a job or module (acquireLink)
+static volatile bool linkPolled = false;     // Short status poll in progress (tryLinkPoll)
+static volatile int8_t checkpointState = -1; // -1 = unknown, 0 = none, 1 = resumable
+
+// Status record, published as a seqlock: odd sequence = write in progress.
+// Writers are serialized by the spinlock, readers never block the job task.
+static JobStatus jobStatus = {};
+static volatile uint32_t statusSeq = 0;
+static portMUX_TYPE statusWriteMux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t jobRetryBase = 0; // linkMetrics.retries at job start
+static JobRange jobRange = {};    // Requested range of the next job (set before the task starts)
+static PreserveRegion jobPreserve[MAX_PRESERVE_REGIONS];
+static uint8_t jobPreserveCount = 0;
+static uint32_t dumpCrc[IMAGE_SLOT_SIZE / CHUNK_SIZE]; // CRC per chunk of the running dump
 
 // --- HELPER CLASSES & FUNCTIONS ---
 
@@ -21,40 +38,380 @@ public:
     ~FileGuard() { if(_f) _f.close(); }
 };
 
-String addrStr(uint32_t addr) {
-    String s = String(addr, HEX); s.toUpperCase();
-    while(s.length() < 4) s = "0" + s;
-    return "0x" + s;
+JobStatus* statusWriteBegin() {
+    portENTER_CRITICAL(&statusWriteMux);
+    __atomic_store_n(&statusSeq, statusSeq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return &jobStatus;
 }
 
-void updateStatus(String msg, int pct = -1) {
-    if(xSemaphoreTake(statusMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        globalStatusMsg = msg;
-        if(pct >= 0) globalPercent = pct;
-        xSemaphoreGive(statusMutex);
+void statusWriteEnd() {
+    jobStatus.updatedMs = millis();
+    jobStatus.retries = linkMetrics.retries - jobRetryBase;
+    jobStatus.clkDelay = cc.get_clock_delay();
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&statusSeq, statusSeq + 1, __ATOMIC_RELAXED);
+    portEXIT_CRITICAL(&statusWriteMux);
+}
+
+// Feeds the duration of the running phase (and of the job, once it has a result) into /metrics
+void closePhaseMetrics(bool final) {
+    uint32_t now = millis();
+    metricsObservePhase(jobStatus.phase, now - jobStatus.phaseMs);
+    if(final) {
+        metricsJobDone(jobStatus.job, jobStatus.code < ERR_NO_RESPONSE, now - jobStatus.startedMs,
+                       uxTaskGetStackHighWaterMark(NULL));
     }
 }
 
-// NEW: Detailed Error Report
+// New job: clears the previous result
+void beginJob(JobType job) {
+    cc.reset_link_speed(); // Step-down of a previous job does not carry over
+    jobRetryBase = linkMetrics.retries;
+    JobStatus* st = statusWriteBegin();
+    uint32_t now = millis();
+    *st = {};
+    st->job = job;
+    st->phase = PHASE_INIT;
+    st->code = ST_BUSY;
+    st->startedMs = now;
+    st->phaseMs = now;
+    statusWriteEnd();
+}
+
+void setPhase(JobPhase phase, uint32_t total = 0, int pct = -1) {
+    closePhaseMetrics(false);
+    JobStatus* st = statusWriteBegin();
+    st->phase = phase;
+    st->code = ST_BUSY;
+    st->addr = 0;
+    st->bytesDone = 0;
+    st->bytesTotal = total;
+    st->phaseMs = millis();
+    if(pct >= 0) st->pct = pct;
+    statusWriteEnd();
+}
+
+// Hot path (every 2KB): plain field stores, no allocation
+void setProgress(uint32_t addr, uint32_t done, int pct) {
+    JobStatus* st = statusWriteBegin();
+    st->addr = addr;
+    st->bytesDone = done;
+    st->pct = pct;
+    statusWriteEnd();
+}
+
+void setResult(StatusCode code, uint32_t addr = 0, int pct = -1) {
+    JobStatus* st = statusWriteBegin();
+    st->code = code;
+    st->addr = addr;
+    if(pct >= 0) st->pct = pct;
+    statusWriteEnd();
+    closePhaseMetrics(true);
+    if(code >= ERR_NO_RESPONSE) traceStop(); // Keep the frames that led to the error
+}
+
+// Detailed Error Report
 // expected = What is in the file (Should be)
 // actual   = What was read from chip (Is)
 void reportMismatch(uint32_t baseAddr, uint8_t* expected, uint8_t* actual, int len) {
     for(int i=0; i<len; i++) {
         if(expected[i] != actual[i]) {
-            String sExp = String(expected[i], HEX); sExp.toUpperCase();
-            if(sExp.length() < 2) sExp = "0" + sExp;
-            
-            String sAct = String(actual[i], HEX); sAct.toUpperCase();
-            if(sAct.length() < 2) sAct = "0" + sAct;
-            
-            // Format: "Mismatch @ 0x1234 (Exp: AA, Act: FF)"
-            updateStatus("Error: Mismatch @ " + addrStr(baseAddr+i) + 
-                         " (Exp:" + sExp + " Act:" + sAct + ")");
+            JobStatus* st = statusWriteBegin();
+            st->code = ERR_MISMATCH;
+            st->addr = baseAddr + i;
+            st->expected = expected[i];
+            st->actual = actual[i];
+            statusWriteEnd();
+            closePhaseMetrics(true);
             return;
         }
     }
     // Fallback if memcmp failed but we found no byte diff (rare)
-    updateStatus("Error: Verify Fail @ " + addrStr(baseAddr));
+    setResult(ERR_VERIFY, baseAddr);
+}
+
+// --- FLASH CHECKPOINT (Resumable Jobs) ---
+// Stored next to the firmware image. Image bytes [0, confirmed) are programmed
+// (at start + offset), everything after it has to be (re-)written on resume.
+
+struct FlashCheckpoint {
+    uint32_t magic;
+    uint32_t imageSize;
+    uint32_t imageCrc;
+    uint32_t pageSize;
+    uint32_t confirmed;
+    uint32_t phase;     // 1 = Writing, 2 = Verifying
+    uint32_t start;     // Flash address of image byte 0
+    uint32_t length;    // Programmed part of the image
+    uint32_t preserveCrc; // Preserved regions in PRESERVE_PATH (0 = none)
+};
+
+enum PageState { PAGE_MATCH, PAGE_BLANK, PAGE_DIRTY, PAGE_UNREADABLE };
+
+// First byte of a page that differs from the intended content
+struct PageMismatch {
+    uint32_t addr;
+    uint8_t expected;
+    uint8_t actual;
+};
+
+bool loadCheckpoint(FlashCheckpoint &ckpt) {
+    File f = LittleFS.open(CKPT_PATH, "r");
+    FileGuard guard(f);
+    if(!f || f.read((uint8_t*)&ckpt, sizeof(ckpt)) != sizeof(ckpt)) return false;
+    return ckpt.magic == CKPT_MAGIC && ckpt.pageSize > 0;
+}
+
+void saveCheckpoint(const FlashCheckpoint &ckpt) {
+    File f = LittleFS.open(CKPT_PATH, "w");
+    FileGuard guard(f);
+    if(f) f.write((const uint8_t*)&ckpt, sizeof(ckpt));
+    checkpointState = 1;
+}
+
+void clearCheckpoint() {
+    if(LittleFS.exists(CKPT_PATH)) LittleFS.remove(CKPT_PATH);
+    checkpointState = 0;
+}
+
+uint32_t imageChecksum(ImageFile &fw, uint8_t* buf) {
+    uint32_t crc = 0;
+    fw.seek(0);
+    while(fw.available()) {
+        int len = fw.read(buf, CHUNK_SIZE);
+        if(len <= 0) break;
+        crc = crc32_update(crc, buf, len);
+    }
+    fw.seek(0);
+    return crc;
+}
+
+// --- PRESERVE REGIONS ---
+// Flash ranges that survive a flash job: read before the erase, laid over
+// the image while writing. A copy in PRESERVE_PATH allows a resume after a
+// reboot, the checkpoint holds its CRC.
+
+const uint32_t MAX_PAGE_SIZE = 2048;  // Largest erase page (CC253x): bound of the kept range tail
+
+static PreserveRegion keepRegions[MAX_PRESERVE_REGIONS + 1]; // + tail of the last page of a range
+static uint8_t keepCount = 0;
+static uint8_t* keepData = nullptr;   // Contents of all regions, in order
+static uint32_t keepBytes = 0;
+
+void freePreserve() {
+    free(keepData);
+    keepData = nullptr;
+    keepCount = 0;
+    keepBytes = 0;
+}
+
+// Clips the requested regions to the erased area [from, to). The part
+// [keepFrom, to) is kept as a whole: the rest of the last page behind a
+// range that does not end on a page boundary (keepFrom = to: nothing).
+bool preparePreserve(const PreserveRegion* req, uint8_t count, uint32_t from, uint32_t to, uint32_t keepFrom) {
+    freePreserve();
+    for(uint8_t i = 0; i < count; i++) {
+        uint32_t s = (req[i].start > from) ? req[i].start : from;
+        uint32_t e = (req[i].start + req[i].length < keepFrom) ? req[i].start + req[i].length : keepFrom;
+        if(s >= e) continue; // Not erased, nothing to do
+        keepRegions[keepCount++] = { s, e - s };
+        keepBytes += e - s;
+    }
+    if(keepBytes > MAX_PRESERVE_BYTES) { keepCount = 0; keepBytes = 0; return false; }
+    if(keepFrom < to) {
+        keepRegions[keepCount++] = { keepFrom, to - keepFrom };
+        keepBytes += to - keepFrom;
+    }
+    if(keepBytes == 0) return true;
+    keepData = (uint8_t*)malloc(keepBytes);
+    if(!keepData) { keepCount = 0; keepBytes = 0; return false; }
+    return true;
+}
+
+uint32_t preserveChecksum() {
+    uint32_t crc = crc32_update(0, (const uint8_t*)keepRegions, keepCount * sizeof(PreserveRegion));
+    return crc32_update(crc, keepData, keepBytes);
+}
+
+// Reads the regions from the chip and stores the copy for a resume
+StatusCode readPreserve() {
+    uint32_t off = 0;
+    for(uint8_t i = 0; i < keepCount; i++) {
+        for(uint32_t pos = 0; pos < keepRegions[i].length; pos += CHUNK_SIZE) {
+            uint16_t len = (keepRegions[i].length - pos < CHUNK_SIZE) ? keepRegions[i].length - pos : CHUNK_SIZE;
+            if(cc.read_code_memory_checked(keepRegions[i].start + pos, len, keepData + off) != 0) return ERR_LINK;
+            off += len;
+        }
+        setProgress(keepRegions[i].start, off, 0);
+    }
+    File f = LittleFS.open(PRESERVE_PATH, "w");
+    FileGuard guard(f);
+    if(!f) return ERR_FS_WRITE;
+    bool ok = f.write(&keepCount, 1) == 1 &&
+              f.write((const uint8_t*)keepRegions, keepCount * sizeof(PreserveRegion)) == keepCount * sizeof(PreserveRegion) &&
+              f.write(keepData, keepBytes) == keepBytes;
+    return ok ? ST_READY : ERR_FS_WRITE;
+}
+
+bool loadPreserve(uint32_t crc) {
+    freePreserve();
+    File f = LittleFS.open(PRESERVE_PATH, "r");
+    FileGuard guard(f);
+    uint8_t count = 0;
+    if(!f || f.read(&count, 1) != 1 || count > MAX_PRESERVE_REGIONS + 1) return false;
+    if(f.read((uint8_t*)keepRegions, count * sizeof(PreserveRegion)) != count * sizeof(PreserveRegion)) return false;
+    uint32_t bytes = 0;
+    for(uint8_t i = 0; i < count; i++) bytes += keepRegions[i].length;
+    if(bytes > MAX_PRESERVE_BYTES + MAX_PAGE_SIZE || (bytes && !(keepData = (uint8_t*)malloc(bytes)))) return false;
+    keepCount = count;
+    keepBytes = bytes;
+    if(f.read(keepData, keepBytes) != keepBytes || preserveChecksum() != crc) { freePreserve(); return false; }
+    return true;
+}
+
+// Intended flash content at addr (>= base): image placed at base, erased
+// (0xFF) behind it, preserved regions on top
+void streamRead(ImageFile &fw, uint32_t base, uint32_t total, uint32_t addr, uint8_t* buf, uint16_t len) {
+    memset(buf, 0xFF, len);
+    if(addr < base + total) {
+        fw.seek(addr - base);
+        fw.read(buf, (base + total - addr < len) ? base + total - addr : len);
+    }
+    uint32_t off = 0;
+    for(uint8_t i = 0; i < keepCount; i++) {
+        const PreserveRegion &r = keepRegions[i];
+        uint32_t s = (r.start > addr) ? r.start : addr;
+        uint32_t e = (r.start + r.length < addr + len) ? r.start + r.length : addr + len;
+        if(s < e) memcpy(buf + (s - addr), keepData + off + (s - r.start), e - s);
+        off += r.length;
+    }
+}
+
+int parsePreserveList(const char* spec, PreserveRegion* regions, uint8_t max) {
+    int count = 0;
+    const char* p = spec;
+    while(*p) {
+        char* end;
+        uint32_t start = strtoul(p, &end, 0);
+        if(end == p || *end != '+' || count >= max) return -1;
+        p = end + 1;
+        uint32_t length = strtoul(p, &end, 0);
+        if(end == p || length == 0) return -1;
+        regions[count++] = { start, length };
+        p = end;
+        if(*p == ',') p++;
+        else if(*p) return -1;
+    }
+    return count;
+}
+
+// Compares flash [addr, addr + len) with the intended content (see streamRead),
+// bad (optional) receives the first differing byte
+PageState checkPage(ImageFile &fw, uint32_t base, uint32_t total, uint32_t addr, uint32_t len, uint8_t* fileBuf, uint8_t* chipBuf,
+                    PageMismatch* bad = nullptr) {
+    PageState state = PAGE_MATCH;
+    for(uint32_t off = 0; off < len; off += CHUNK_SIZE) {
+        uint16_t n = (len - off < CHUNK_SIZE) ? len - off : CHUNK_SIZE;
+        streamRead(fw, base, total, addr + off, fileBuf, n);
+        if(cc.read_code_memory_checked(addr + off, n, chipBuf) != 0) return PAGE_UNREADABLE;
+        for(uint16_t i = 0; i < n; i++) {
+            if(chipBuf[i] == fileBuf[i]) continue;
+            if(bad && state == PAGE_MATCH) *bad = { addr + off + i, fileBuf[i], chipBuf[i] };
+            if(chipBuf[i] != 0xFF) return PAGE_DIRTY;
+            state = PAGE_BLANK; // Not yet programmed
+        }
+    }
+    return state;
+}
+
+// Programs [from, to) with the intended content, erased (all 0xFF) chunks are skipped
+// Returns: 0 = OK, otherwise the address of the failing chunk + 1
+uint32_t writeSpan(ImageFile &fw, uint32_t base, uint32_t total, uint32_t from, uint32_t to, uint8_t* buf) {
+    from &= ~3UL; // Flash word boundary (4 bytes on CC253x)
+    for(uint32_t addr = from; addr < to; addr += CHUNK_SIZE) {
+        uint16_t n = (to - addr < CHUNK_SIZE) ? to - addr : CHUNK_SIZE;
+        streamRead(fw, base, total, addr, buf, n);
+        uint16_t i = 0;
+        while(i < n && buf[i] == 0xFF) i++;
+        if(i == n) continue;
+        if(cc.write_code_memory(addr, buf, n) != 0) return addr + 1;
+    }
+    return 0;
+}
+
+// Verify mismatch after writing: erases the page and programs it again from
+// the image instead of starting over with a full chip erase.
+// Returns: PAGE_MATCH = page reads back correctly, PAGE_UNREADABLE = link failed,
+// otherwise bad holds the first byte that is still wrong
+PageState repairPage(ImageFile &fw, uint32_t base, uint32_t total, uint32_t pageAddr, uint32_t pageSize,
+                     uint8_t* fileBuf, uint8_t* chipBuf, PageMismatch &bad) {
+    PageState state = PAGE_DIRTY;
+    for(uint8_t attempt = 0; attempt < PAGE_REPAIR_ATTEMPTS; attempt++) {
+        JobStatus* st = statusWriteBegin();
+        st->repairs++;
+        statusWriteEnd();
+
+        // A failed erase or write is judged by what the page holds afterwards
+        if(cc.erase_page(pageAddr) == 0) writeSpan(fw, base, total, pageAddr, pageAddr + pageSize, fileBuf);
+        state = checkPage(fw, base, total, pageAddr, pageSize, fileBuf, chipBuf, &bad);
+        metricsPageRepair(state == PAGE_MATCH);
+        if(state == PAGE_MATCH || state == PAGE_UNREADABLE) return state;
+    }
+    return state;
+}
+
+// Phase 2 of task_Flash for [from, to): repairs failing pages, reports what cannot be fixed
+// Returns: false = job failed (result is set)
+bool verifySpan(ImageFile &fw, const FlashCheckpoint &ckpt, uint32_t from, uint32_t to, uint8_t* buffer, uint8_t* chipBuf) {
+    uint32_t base = ckpt.start, total = ckpt.length;
+    uint32_t addr = from;
+    while(addr < to) {
+        uint16_t len = (to - addr < CHUNK_SIZE) ? to - addr : CHUNK_SIZE;
+        streamRead(fw, base, total, addr, buffer, len);
+        // Read Chip
+        if(cc.read_code_memory_checked(addr, len, chipBuf) != 0) {
+            setResult(ERR_LINK, addr);
+            return false;
+        }
+        uint32_t pos = addr - base;
+        int pct = 50 + (((pos < total ? pos : total) * 50) / total);
+        
+        if(memcmp(buffer, chipBuf, len) != 0) { 
+            // Reprogram the page before giving up
+            uint32_t pageAddr = addr - (addr % ckpt.pageSize);
+            setPhase(PHASE_REPAIR, ckpt.pageSize);
+            setProgress(pageAddr, 0, pct);
+            PageMismatch bad;
+            PageState state = repairPage(fw, base, total, pageAddr, ckpt.pageSize, buffer, chipBuf, bad);
+            if(state == PAGE_UNREADABLE) { setResult(ERR_LINK, pageAddr); return false; }
+            if(state != PAGE_MATCH) {
+                // Report the byte that is still wrong, anywhere in the page
+                reportMismatch(bad.addr, &bad.expected, &bad.actual, 1);
+                return false;
+            }
+            setPhase(PHASE_VERIFY, total);
+            addr = pageAddr + ckpt.pageSize;
+            setProgress(addr, pos, pct);
+            continue;
+        }
+        
+        addr += len;
+        if(addr % 2048 == 0) setProgress(addr, pos + len, pct);
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+// Clips the requested range to the flash (and to the image, imageSize > 0).
+// Returns: false = range empty or outside the flash
+bool resolveRange(const JobRange &req, uint32_t imageSize, uint32_t &start, uint32_t &len) {
+    uint32_t flashSize = cc.detect_flash_size();
+    start = req.start;
+    if(start >= flashSize) return false;
+    len = req.length ? req.length : flashSize - start;
+    if(imageSize > 0 && (req.length == 0 || len > imageSize)) len = imageSize;
+    return len > 0 && len <= flashSize - start;
 }
 
 // --- TASKS IMPLEMENTATION ---
@@ -62,198 +419,318 @@ void reportMismatch(uint32_t baseAddr, uint8_t* expected, uint8_t* actual, int l
 void task_Dump(void * parameter) {
     isFlashing = true; 
     
-    updateStatus("BUSY: Init Debug-Mode...", 0);
+    beginJob(JOB_DUMP);
     cc.enable_cc_debug();
     if(cc.clock_init() != 0) {
-        updateStatus("Error: Chip not responding");
+        setResult(ERR_NO_RESPONSE);
         isFlashing = false; vTaskDelete(NULL); return;
     }
 
-    updateStatus("BUSY: Detecting Chip...", 0);
-    uint32_t size = cc.detect_flash_size();
+    setPhase(PHASE_DETECT);
+    uint32_t start, size;
+    if(!resolveRange(jobRange, 0, start, size)) {
+        setResult(ERR_RANGE, jobRange.start);
+        isFlashing = false; vTaskDelete(NULL); return;
+    }
     
-    if(LittleFS.exists("/dump.bin")) LittleFS.remove("/dump.bin");
-    File dumpFile = LittleFS.open("/dump.bin", "w");
-    FileGuard fileGuard(dumpFile);
-
-    if(!dumpFile) {
-        updateStatus("Error: FS Write Fail");
+    ImageFile dumpFile;
+    if(!dumpFile.open(IMG_DUMP, "w")) {
+        setResult(ERR_FS_WRITE);
         isFlashing = false; vTaskDelete(NULL); return;
     }
 
     // Phase 1: Reading
-    updateStatus("BUSY: [1/2] Reading Flash...", 0);
+    setPhase(PHASE_READ, size, 0);
     vTaskDelay(500); 
 
     uint8_t buffer[CHUNK_SIZE];
-    uint32_t addr = 0;
-    while(addr < size) {
-        uint32_t remaining = size - addr;
+    uint32_t pos = 0; // Offset in the range
+    while(pos < size) {
+        uint32_t remaining = size - pos;
         uint16_t len = (remaining < CHUNK_SIZE) ? remaining : CHUNK_SIZE;
-        cc.read_code_memory(addr, len, buffer);
-        dumpFile.write(buffer, len);
-        addr += len;
-        if(addr % 2048 == 0) updateStatus("BUSY: [1/2] Reading @ " + addrStr(addr), (addr * 50) / size);
+        if(cc.read_code_memory_checked(start + pos, len, buffer) != 0) {
+            dumpFile.close();
+            imageRemove(IMG_DUMP);
+            setResult(ERR_LINK, start + pos);
+            isFlashing = false; vTaskDelete(NULL); return;
+        }
+        if(dumpFile.write(buffer, len) != len) {
+            dumpFile.close();
+            setResult(ERR_FS_WRITE, start + pos);
+            isFlashing = false; vTaskDelete(NULL); return;
+        }
+        dumpCrc[pos / CHUNK_SIZE] = crc32_update(0, buffer, len);
+        pos += len;
+        if(pos % 2048 == 0) setProgress(start + pos, pos, (pos * 50) / size);
         vTaskDelay(1); 
     }
     dumpFile.close(); 
 
-    // Phase 2: Verify
-    updateStatus("BUSY: [2/2] Verifying...", 50);
+    // Phase 2: Verify (second read against the chunk CRCs, the stored dump
+    // may be compressed)
+    setPhase(PHASE_VERIFY, size, 50);
     vTaskDelay(500); 
 
-    dumpFile = LittleFS.open("/dump.bin", "r");
-    FileGuard readGuard(dumpFile);
-
-    addr = 0;
-    uint8_t fileBuf[CHUNK_SIZE];
+    pos = 0;
     bool mismatch = false;
 
-    while(addr < size && dumpFile.available()) {
-        uint32_t remaining = size - addr;
+    while(pos < size) {
+        uint32_t remaining = size - pos;
         uint16_t len = (remaining < CHUNK_SIZE) ? remaining : CHUNK_SIZE;
         
         // Read Chip (Actual)
-        cc.read_code_memory(addr, len, buffer);
-        // Read File (Expected)
-        dumpFile.read(fileBuf, len);
+        if(cc.read_code_memory_checked(start + pos, len, buffer) != 0) {
+            mismatch = true;
+            setResult(ERR_LINK, start + pos);
+            break;
+        }
         
-        if(memcmp(buffer, fileBuf, len) != 0) {
+        if(crc32_update(0, buffer, len) != dumpCrc[pos / CHUNK_SIZE]) {
             mismatch = true;
-            reportMismatch(addr, fileBuf, buffer, len);
+            setResult(ERR_VERIFY, start + pos);
             break;
         }
-        addr += len;
-        if(addr % 2048 == 0) updateStatus("BUSY: [2/2] Verifying @ " + addrStr(addr), 50 + ((addr * 50) / size));
+        pos += len;
+        if(pos % 2048 == 0) setProgress(start + pos, pos, 50 + ((pos * 50) / size));
         vTaskDelay(1);
     }
 
-    if(!mismatch) updateStatus("DUMP_READY", 100);
+    if(!mismatch) setResult(ST_DUMP_READY, 0, 100);
     isFlashing = false;
     vTaskDelete(NULL);
 }
 
+// Image byte 0 is written to ckpt.start. The whole chip is erased unless a
+// range was requested, then only the pages the image touches are erased
+// (the range has to start on a page boundary). Preserved regions inside the
+// erased area are read first and programmed back with the image.
 void task_Flash(void * parameter) {
+    bool resume = (parameter != NULL);
     isFlashing = true; 
     
-    updateStatus("BUSY: Init Debug-Mode...", 0);
+    beginJob(JOB_FLASH);
     cc.enable_cc_debug();
     cc.clock_init(); 
 
-    updateStatus("BUSY: Preparing...", 0);
-    if(!LittleFS.exists("/firmware.bin")){ 
-        updateStatus("Error: File missing!"); isFlashing = false; vTaskDelete(NULL); return; 
+    setPhase(PHASE_PREPARE, 0, 0);
+    ImageFile fw;
+    if(!fw.open(IMG_FIRMWARE)){ 
+        setResult(ERR_FILE_MISSING); isFlashing = false; vTaskDelete(NULL); return; 
     }
-    
-    File fw = LittleFS.open("/firmware.bin", "r");
-    FileGuard fwGuard(fw);
 
     size_t fileSize = fw.size();
-    updateStatus("BUSY: Erasing Chip...");
-    if(cc.erase_chip() != 0) { 
-        fw.close(); 
-        LittleFS.remove("/firmware.bin"); 
-        updateStatus("Error: Erase Fail!"); isFlashing = false; vTaskDelete(NULL); return; 
+    uint8_t buffer[CHUNK_SIZE]; 
+    uint8_t chipBuf[CHUNK_SIZE];
+    uint32_t imageCrc = imageChecksum(fw, buffer);
+    FlashCheckpoint ckpt;
+
+    if(resume) {
+        if(!loadCheckpoint(ckpt) || ckpt.imageSize != fileSize || ckpt.imageCrc != imageCrc ||
+           (ckpt.preserveCrc && !loadPreserve(ckpt.preserveCrc))) {
+            clearCheckpoint();
+            setResult(ERR_NO_CHECKPOINT); isFlashing = false; vTaskDelete(NULL); return;
+        }
+        if(!ckpt.preserveCrc) freePreserve();
+    } else {
+        bool ranged = jobRange.start != 0 || jobRange.length != 0;
+        uint32_t start, length;
+        ckpt = { CKPT_MAGIC, (uint32_t)fileSize, imageCrc, cc.get_flash_page_size(), 0, 1, 0, 0, 0 };
+        if(!resolveRange(jobRange, fileSize, start, length) || start % ckpt.pageSize != 0) {
+            setResult(ERR_RANGE, jobRange.start); isFlashing = false; vTaskDelete(NULL); return;
+        }
+        ckpt.start = start;
+        ckpt.length = length;
+
+        // Erased area: whole chip or the pages of the range
+        uint32_t eraseEnd = ranged ? start + ((length + ckpt.pageSize - 1) / ckpt.pageSize) * ckpt.pageSize
+                                   : cc.detect_flash_size();
+        // A ranged flash keeps what follows the range in its last page
+        if(!preparePreserve(jobPreserve, jobPreserveCount, start, eraseEnd, ranged ? start + length : eraseEnd)) {
+            setResult(ERR_PRESERVE); isFlashing = false; vTaskDelete(NULL); return;
+        }
+        if(keepCount > 0) {
+            setPhase(PHASE_PRESERVE, keepBytes);
+            StatusCode rc = readPreserve();
+            if(rc != ST_READY) {
+                freePreserve();
+                setResult(rc); isFlashing = false; vTaskDelete(NULL); return;
+            }
+            ckpt.preserveCrc = preserveChecksum();
+        }
+
+        bool erased = true;
+        if(ranged) {
+            setPhase(PHASE_ERASE, eraseEnd - start);
+            for(uint32_t page = start; erased && page < eraseEnd; page += ckpt.pageSize) {
+                erased = cc.erase_page(page) == 0;
+                setProgress(page, page - start, 0);
+            }
+        } else {
+            setPhase(PHASE_ERASE);
+            erased = cc.erase_chip() == 0;
+        }
+        if(!erased) { 
+            // PRESERVE_PATH stays: the regions may already be erased
+            freePreserve();
+            fw.close(); 
+            imageRemove(IMG_FIRMWARE); 
+            clearCheckpoint();
+            setResult(ranged ? ERR_ERASE_PAGE : ERR_ERASE); isFlashing = false; vTaskDelete(NULL); return; 
+        }
+        saveCheckpoint(ckpt);
     }
 
+    uint32_t base = ckpt.start;    // Flash address of image byte 0
+    uint32_t total = ckpt.length;  // Bytes of the image that are programmed
+    uint32_t pos = 0;              // Offset in the image
+
     // Phase 1: Writing
-    updateStatus("BUSY: [1/2] Writing...", 0);
-    vTaskDelay(500);
-    uint8_t buffer[CHUNK_SIZE]; 
-    uint16_t addr = 0; 
-    bool error = false;
-    
-    while(fw.available()){
-        int len = fw.read(buffer, CHUNK_SIZE);
-        if(len > 0){
-            if(cc.write_code_memory(addr, buffer, len) != 0) { 
-                error = true; updateStatus("Error: Write Fail @ " + addrStr(addr)); break; 
+    if(ckpt.phase == 1) {
+        pos = ckpt.confirmed;
+        setPhase(PHASE_WRITE, total, (pos * 50) / total);
+        vTaskDelay(500);
+
+        // The page after the checkpoint may be half-written: re-check only this one
+        if(resume && pos < total) {
+            setPhase(PHASE_RESUME, total);
+            setProgress(base + pos, pos, (pos * 50) / total);
+            uint32_t pageLen = (total - pos < ckpt.pageSize) ? total - pos : ckpt.pageSize;
+            int state = checkPage(fw, base, total, base + pos, pageLen, buffer, chipBuf);
+            if(state == PAGE_UNREADABLE) {
+                freePreserve();
+                setResult(ERR_LINK, base + pos); isFlashing = false; vTaskDelete(NULL); return;
+            }
+            if(state == PAGE_MATCH) {
+                pos += pageLen;
+                ckpt.confirmed = pos;
+                saveCheckpoint(ckpt);
+            } else if(state == PAGE_DIRTY && cc.erase_page(base + pos) != 0) {
+                freePreserve();
+                setResult(ERR_ERASE_PAGE, base + pos); isFlashing = false; vTaskDelete(NULL); return;
+            }
+        }
+
+        uint32_t failed = 0;
+        while(pos < total){
+            uint16_t len = (total - pos < CHUNK_SIZE) ? total - pos : CHUNK_SIZE;
+            streamRead(fw, base, total, base + pos, buffer, len);
+            if(cc.write_code_memory(base + pos, buffer, len) != 0) { 
+                failed = base + pos + 1; break; 
             }
-            addr += len;
-            if(addr % 2048 == 0) updateStatus("BUSY: [1/2] Writing @ " + addrStr(addr), (addr * 50) / fileSize);
+            pos += len;
+            if(pos % ckpt.pageSize == 0 || pos >= total) {
+                ckpt.confirmed = pos;
+                saveCheckpoint(ckpt);
+            }
+            if(pos % 2048 == 0) setProgress(base + pos, pos, (pos * 50) / total);
             vTaskDelay(1); 
         }
+
+        // Preserved regions behind the image
+        for(uint8_t i = 0; !failed && i < keepCount; i++) {
+            uint32_t from = (keepRegions[i].start > base + total) ? keepRegions[i].start : base + total;
+            uint32_t to = keepRegions[i].start + keepRegions[i].length;
+            if(from < to) failed = writeSpan(fw, base, total, from, to, buffer);
+        }
+        
+        // Keep image and checkpoint so the job can be resumed
+        if(failed) {
+            freePreserve();
+            setResult(ERR_WRITE, failed - 1); isFlashing = false; vTaskDelete(NULL); return;
+        }
+
+        ckpt.phase = 2;
+        saveCheckpoint(ckpt);
     }
-    
-    if(error) { LittleFS.remove("/firmware.bin"); isFlashing = false; vTaskDelete(NULL); return; }
 
     // Phase 2: Verify
-    updateStatus("BUSY: [2/2] Verifying...", 50);
+    setPhase(PHASE_VERIFY, total, 50);
     vTaskDelay(500);
-    fw.seek(0);
-    addr = 0; 
-    uint8_t chipBuf[CHUNK_SIZE];
-    
-    while(fw.available()){
-        int len = fw.read(buffer, CHUNK_SIZE);
-        if(len > 0){
-            // Read Chip
-            cc.read_code_memory(addr, len, chipBuf);
-            
-            if(memcmp(buffer, chipBuf, len) != 0) { 
-                error = true; 
-                reportMismatch(addr, buffer, chipBuf, len);
-                break; 
-            }
-            
-            addr += len;
-            if(addr % 2048 == 0) updateStatus("BUSY: [2/2] Checking @ " + addrStr(addr), 50 + ((addr * 50) / fileSize));
-            vTaskDelay(1);
-        }
+    bool ok = verifySpan(fw, ckpt, base, base + total, buffer, chipBuf);
+    for(uint8_t i = 0; ok && i < keepCount; i++) {
+        uint32_t from = (keepRegions[i].start > base + total) ? keepRegions[i].start : base + total;
+        uint32_t to = keepRegions[i].start + keepRegions[i].length;
+        if(from < to) ok = verifySpan(fw, ckpt, from, to, buffer, chipBuf);
     }
+    freePreserve();
 
     fw.close(); 
-    LittleFS.remove("/firmware.bin");
-    if(!error) { 
+    // Failed with preserved regions: image, checkpoint and PRESERVE_PATH stay,
+    // a resume verifies again and repairs the pages from the saved copy
+    if(ok || !ckpt.preserveCrc) {
+        imageRemove(IMG_FIRMWARE);
+        clearCheckpoint();
+    }
+    if(ok) { 
+        if(LittleFS.exists(PRESERVE_PATH)) LittleFS.remove(PRESERVE_PATH);
         cc.reset_cc(); 
-        updateStatus("Success: Flash & Verify OK!", 100); 
+        setResult(ST_FLASH_OK, 0, 100); 
     }
     isFlashing = false; 
     vTaskDelete(NULL);
 }
 
+// Preserve regions of the verify job hold the kept data, not the image:
+// their bytes are taken from the chip, so they always compare equal
+static void skipPreserved(uint32_t addr, uint8_t* fileBuf, const uint8_t* chipBuf, uint32_t len) {
+    for(uint8_t i = 0; i < jobPreserveCount; i++) {
+        uint32_t s = (jobPreserve[i].start > addr) ? jobPreserve[i].start : addr;
+        uint32_t e = (jobPreserve[i].start + jobPreserve[i].length < addr + len) ? jobPreserve[i].start + jobPreserve[i].length : addr + len;
+        if(s < e) memcpy(fileBuf + (s - addr), chipBuf + (s - addr), e - s);
+    }
+}
+
+// Compares the uploaded image with the flash starting at jobRange.start
 void task_Verify(void * parameter) {
     isFlashing = true; 
     
-    updateStatus("BUSY: Init Debug-Mode...", 0);
+    beginJob(JOB_VERIFY);
     cc.enable_cc_debug();
     if(cc.clock_init() != 0) {
-        updateStatus("Error: Chip not responding");
+        setResult(ERR_NO_RESPONSE);
         isFlashing = false; vTaskDelete(NULL); return;
     }
 
-    updateStatus("BUSY: Start Verify...", 0);
-    if(!LittleFS.exists("/firmware.bin")){ 
-        updateStatus("Error: File missing!"); isFlashing = false; vTaskDelete(NULL); return; 
+    ImageFile fw;
+    if(!fw.open(IMG_FIRMWARE)){ 
+        setResult(ERR_FILE_MISSING); isFlashing = false; vTaskDelete(NULL); return; 
+    }
+
+    uint32_t base, total;
+    if(!resolveRange(jobRange, fw.size(), base, total)) {
+        setResult(ERR_RANGE, jobRange.start); isFlashing = false; vTaskDelete(NULL); return;
     }
-    
-    File fw = LittleFS.open("/firmware.bin", "r");
-    FileGuard fwGuard(fw);
 
-    size_t fileSize = fw.size();
     uint8_t fileBuf[CHUNK_SIZE]; 
     uint8_t chipBuf[CHUNK_SIZE]; 
-    uint16_t addr = 0; 
+    uint32_t pos = 0; 
     bool mismatch = false;
 
-    while(fw.available()){
-        int len = fw.read(fileBuf, CHUNK_SIZE);
-        if(len > 0){
-            // Read Chip
-            cc.read_code_memory(addr, len, chipBuf);
-            
-            if(memcmp(fileBuf, chipBuf, len) != 0) { 
-                mismatch = true; 
-                reportMismatch(addr, fileBuf, chipBuf, len);
-                break; 
-            }
-            addr += len;
-            if(addr % 2048 == 0) updateStatus("BUSY: Checking @ " + addrStr(addr), (addr * 100) / fileSize);
-            vTaskDelay(1);
+    setPhase(PHASE_VERIFY, total, 0);
+
+    while(pos < total){
+        int len = fw.read(fileBuf, (total - pos < CHUNK_SIZE) ? total - pos : CHUNK_SIZE);
+        if(len <= 0) break;
+        // Read Chip
+        if(cc.read_code_memory_checked(base + pos, len, chipBuf) != 0) {
+            mismatch = true;
+            setResult(ERR_LINK, base + pos);
+            break;
         }
+        
+        skipPreserved(base + pos, fileBuf, chipBuf, len);
+        if(memcmp(fileBuf, chipBuf, len) != 0) { 
+            mismatch = true; 
+            reportMismatch(base + pos, fileBuf, chipBuf, len);
+            break; 
+        }
+        pos += len;
+        if(pos % 2048 == 0) setProgress(base + pos, pos, (pos * 100) / total);
+        vTaskDelay(1);
     }
     
-    if(!mismatch) updateStatus("Success: Chip identical!", 100);
+    fw.close();
+    if(!mismatch) setResult(ST_VERIFY_OK, 0, 100);
     isFlashing = false; 
     vTaskDelete(NULL);
 }
@@ -261,48 +738,108 @@ void task_Verify(void * parameter) {
 // --- PUBLIC INTERFACE ---
 
 void initFlasherController() {
-    statusMutex = xSemaphoreCreateMutex();
+    JobStatus* st = statusWriteBegin();
+    st->code = ST_READY;
+    statusWriteEnd();
 }
 
-String getStatusJSON() {
-    String msgCopy;
-    int pctCopy;
-    if(xSemaphoreTake(statusMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-        msgCopy = globalStatusMsg;
-        pctCopy = globalPercent;
-        xSemaphoreGive(statusMutex);
-    } else {
-        msgCopy = "Busy/Timeout"; pctCopy = 0;
-    }
-    return "{\"msg\":\"" + msgCopy + "\",\"pct\":" + String(pctCopy) + "}";
+JobStatus getJobStatus() {
+    JobStatus copy;
+    uint32_t s1, s2;
+    do {
+        s1 = __atomic_load_n(&statusSeq, __ATOMIC_ACQUIRE);
+        memcpy(&copy, (const void*)&jobStatus, sizeof(copy));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        s2 = __atomic_load_n(&statusSeq, __ATOMIC_RELAXED);
+    } while((s1 & 1) || s1 != s2);
+    return copy;
+}
+
+size_t formatStatusJSON(char* buf, size_t len) {
+    JobStatus st = getJobStatus();
+    int n = snprintf(buf, len,
+        "{\"job\":%u,\"phase\":%u,\"code\":%u,\"pct\":%u,\"addr\":%lu,\"exp\":%u,\"act\":%u,"
+        "\"done\":%lu,\"total\":%lu,\"t0\":%lu,\"tp\":%lu,\"t\":%lu,\"retries\":%u,\"clk\":%u,\"repairs\":%u,\"resume\":%s}",
+        st.job, st.phase, st.code, st.pct, (unsigned long)st.addr, st.expected, st.actual,
+        (unsigned long)st.bytesDone, (unsigned long)st.bytesTotal,
+        (unsigned long)st.startedMs, (unsigned long)st.phaseMs, (unsigned long)st.updatedMs,
+        st.retries, st.clkDelay, st.repairs,
+        hasFlashCheckpoint() ? "true" : "false");
+    return (n < 0) ? 0 : ((size_t)n < len ? n : len - 1);
+}
+
+uint32_t getStatusSeq() {
+    return statusSeq;
 }
 
 bool isSystemBusy() {
     return isFlashing;
 }
 
-bool startDumpTask() {
-    if(isFlashing) return false;
+// Both flags are set before the other one is checked (sequentially consistent),
+// so either the poll sees the owner or the owner waits for the poll.
+bool acquireLink() {
+    bool expected = false;
+    if(!__atomic_compare_exchange_n(&isFlashing, &expected, true, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) return false;
+    while(__atomic_load_n(&linkPolled, __ATOMIC_SEQ_CST)) vTaskDelay(1);
+    return true;
+}
+
+void releaseLink() {
+    __atomic_store_n(&isFlashing, false, __ATOMIC_SEQ_CST);
+}
+
+bool tryLinkPoll() {
+    __atomic_store_n(&linkPolled, true, __ATOMIC_SEQ_CST);
+    if(!__atomic_load_n(&isFlashing, __ATOMIC_SEQ_CST)) return true;
+    __atomic_store_n(&linkPolled, false, __ATOMIC_SEQ_CST);
+    return false;
+}
+
+void endLinkPoll() {
+    __atomic_store_n(&linkPolled, false, __ATOMIC_SEQ_CST);
+}
+
+bool startDumpTask(uint32_t start, uint32_t length) {
+    if(dumpReaderActive() || !acquireLink()) return false;
+    jobRange = { start, length };
     xTaskCreate(task_Dump, "Dump", 8192, NULL, 1, NULL);
     return true;
 }
 
-bool startFlashTask() {
-    if(isFlashing) return false;
-    xTaskCreate(task_Flash, "Flash", 8192, NULL, 1, NULL);
+bool startFlashTask(bool resume, uint32_t start, uint32_t length, const PreserveRegion* preserve, uint8_t preserveCount) {
+    if(resume && !hasFlashCheckpoint()) return false;
+    if(!acquireLink()) return false;
+    jobRange = { start, length };
+    jobPreserveCount = (preserveCount < MAX_PRESERVE_REGIONS) ? preserveCount : MAX_PRESERVE_REGIONS;
+    if(jobPreserveCount) memcpy(jobPreserve, preserve, jobPreserveCount * sizeof(PreserveRegion));
+    xTaskCreate(task_Flash, "Flash", 8192, resume ? (void*)1 : NULL, 1, NULL);
     return true;
 }
 
-bool startVerifyTask() {
-    if(isFlashing) return false;
+bool hasFlashCheckpoint() {
+    if(checkpointState < 0) checkpointState = LittleFS.exists(CKPT_PATH) ? 1 : 0;
+    // A PSRAM image is gone after a reboot
+    return checkpointState == 1 && imageExists(IMG_FIRMWARE);
+}
+
+void discardFlashCheckpoint() {
+    if(!isFlashing) clearCheckpoint();
+}
+
+bool startVerifyTask(uint32_t start, uint32_t length, const PreserveRegion* preserve, uint8_t preserveCount) {
+    if(!acquireLink()) return false;
+    jobRange = { start, length };
+    jobPreserveCount = (preserveCount < MAX_PRESERVE_REGIONS) ? preserveCount : MAX_PRESERVE_REGIONS;
+    if(jobPreserveCount) memcpy(jobPreserve, preserve, jobPreserveCount * sizeof(PreserveRegion));
     xTaskCreate(task_Verify, "Verify", 8192, NULL, 1, NULL);
     return true;
 }
 
 void actionLockChip(void (*onSuccess)()) {
-    if(isFlashing) return;
-    isFlashing = true; 
-    updateStatus("BUSY: Setting Lock-Bits...", 0);
+    if(!acquireLink()) return;
+    beginJob(JOB_LOCK);
+    setPhase(PHASE_LOCK, 0, 0);
     
     cc.enable_cc_debug();
     cc.clock_init();
@@ -312,13 +849,13 @@ void actionLockChip(void (*onSuccess)()) {
     if(onSuccess) onSuccess(); 
     
     isFlashing = false;
-    updateStatus("Success: Chip Locked (Read Protected)!", 100);
+    setResult(ST_LOCK_OK, 0, 100);
 }
 
 bool actionEraseChip() {
-    if(isFlashing) return false;
-    isFlashing = true; 
-    updateStatus("BUSY: Starting Chip Erase...", 0);
+    if(!acquireLink()) return false;
+    beginJob(JOB_ERASE);
+    setPhase(PHASE_ERASE, 0, 0);
 
     cc.enable_cc_debug();
     cc.clock_init(); 
@@ -326,9 +863,9 @@ bool actionEraseChip() {
 
     if(result == 0) {
         cc.reset_cc();
-        updateStatus("Success: Chip erased & unlocked!", 100);
+        setResult(ST_ERASE_OK, 0, 100);
     } else {
-        updateStatus("Error: Erase failed (Timeout)!", 0);
+        setResult(ERR_ERASE, 0, 0);
     }
     isFlashing = false;
     return (result == 0);
@@ -4,15 +4,91 @@
 // Initialization (Mutex, etc.)
 void initFlasherController();
 
-// Status Check for API
-String getStatusJSON();
+// --- JOB STATUS ---
+// Fixed-layout record, written by the job tasks without heap allocation.
+// The browser turns phase/code into localized text (see web_lang.h).
+enum JobType : uint8_t { JOB_NONE, JOB_DUMP, JOB_FLASH, JOB_VERIFY, JOB_ERASE, JOB_LOCK };
+
+enum JobPhase : uint8_t {
+    PHASE_IDLE, PHASE_INIT, PHASE_DETECT, PHASE_PREPARE, PHASE_ERASE,
+    PHASE_READ, PHASE_WRITE, PHASE_VERIFY, PHASE_RESUME, PHASE_LOCK, PHASE_REPAIR, PHASE_PRESERVE
+};
+
+enum StatusCode : uint8_t {
+    ST_READY = 0, ST_BUSY, ST_DUMP_READY, ST_FLASH_OK, ST_VERIFY_OK, ST_ERASE_OK, ST_LOCK_OK,
+    // Errors (>= 0x20)
+    ERR_NO_RESPONSE = 0x20, ERR_FS_WRITE, ERR_FILE_MISSING, ERR_NO_CHECKPOINT,
+    ERR_ERASE, ERR_ERASE_PAGE, ERR_WRITE, ERR_MISMATCH, ERR_VERIFY, ERR_LINK, ERR_RANGE, ERR_PRESERVE
+};
+
+struct JobStatus {
+    uint8_t job;          // JobType
+    uint8_t phase;        // JobPhase
+    uint8_t code;         // StatusCode
+    uint8_t pct;          // Overall progress 0-100
+    uint8_t expected;     // ERR_MISMATCH: byte in the image
+    uint8_t actual;       // ERR_MISMATCH: byte read from the chip
+    uint16_t retries;     // Link retries in this job (checksum mismatches)
+    uint8_t clkDelay;     // Current debug clock half period (us), raised after errors
+    uint16_t repairs;     // Pages erased and reprogrammed after a verify mismatch
+    uint32_t addr;        // Current / failing address
+    uint32_t bytesDone;   // Progress within the phase
+    uint32_t bytesTotal;
+    uint32_t startedMs;   // Job start (millis)
+    uint32_t phaseMs;     // Phase start (millis)
+    uint32_t updatedMs;   // Last update (millis)
+};
+
+// Consistent snapshot, never blocks the writer
+JobStatus getJobStatus();
+size_t formatStatusJSON(char* buf, size_t len);
 bool isSystemBusy();
 
+// Push Events: changes whenever a new status is available,
+// the caller coalesces and publishes (see pumpEvents in main.cpp)
+uint32_t getStatusSeq();
+
+// Flash address range of a job. length 0 = up to the end of the flash (dump)
+// or of the image (flash, verify). Image byte 0 belongs to address start.
+struct JobRange {
+    uint32_t start;
+    uint32_t length;
+};
+
+// Flash ranges kept by a flash job (IEEE address, NV pages, calibration data):
+// read before the erase and programmed again together with the image
+struct PreserveRegion {
+    uint32_t start;
+    uint32_t length;
+};
+const uint8_t MAX_PRESERVE_REGIONS = 8;
+const uint32_t MAX_PRESERVE_BYTES = 16384;
+
+// "start+length,start+length,..." (decimal or 0x-hex)
+// Returns: number of regions, -1 = syntax error or more than max
+int parsePreserveList(const char* spec, PreserveRegion* regions, uint8_t max);
+
 // Start background tasks
 // Returns: true = Task started, false = System busy
-bool startDumpTask();
-bool startFlashTask();
-bool startVerifyTask();
+bool startDumpTask(uint32_t start = 0, uint32_t length = 0);
+// resume = continue from checkpoint (range and preserved data from the checkpoint)
+bool startFlashTask(bool resume = false, uint32_t start = 0, uint32_t length = 0,
+                    const PreserveRegion* preserve = nullptr, uint8_t preserveCount = 0);
+// preserve: regions kept by the flash job before, skipped in the comparison
+bool startVerifyTask(uint32_t start = 0, uint32_t length = 0,
+                     const PreserveRegion* preserve = nullptr, uint8_t preserveCount = 0);
+
+// Resumable Flash (Checkpoint of programmed pages in LittleFS)
+bool hasFlashCheckpoint();
+void discardFlashCheckpoint();
+
+// Exclusive use of the debug link by other modules (benchmark, ...)
+bool acquireLink(); // false = a job is running (waits for a status poll in progress)
+void releaseLink();
+// Short status poll from a background task (halt watch): never waits,
+// false = the link is taken. acquireLink() waits until endLinkPoll().
+bool tryLinkPoll();
+void endLinkPoll();
 
 // Direct Actions (Blocking or fast)
 void actionLockChip(void (*onSuccess)());
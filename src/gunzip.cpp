@@ -0,0 +1,123 @@
+#include "gunzip.h"
+#include "crc32.h"
+#include "rom/miniz.h"
+
+// Header fields behind the fixed 10 bytes (RFC 1952, 2.3), in stream order
+enum HeaderStep : uint8_t { HDR_FIXED, HDR_EXTRA_LEN, HDR_EXTRA, HDR_NAME, HDR_COMMENT, HDR_CRC, HDR_DONE };
+
+struct GunzipWriter::State {
+    tinfl_decompressor inflater;
+    uint8_t window[TINFL_LZ_DICT_SIZE];  // tinfl wraps its output around this buffer
+    size_t windowPos;
+    tinfl_status status;
+    bool inflated;        // End of the deflate stream seen
+    uint8_t step, flags;  // Header parser
+    uint16_t count, extra;
+    uint32_t crc, size;   // Of the inflated data
+    uint8_t tail[8];      // Last 8 input bytes = trailer (CRC-32, size)
+};
+
+static uint8_t nextStep(uint8_t &flags) {
+    if(flags & 0x04) { flags &= ~0x04; return HDR_EXTRA_LEN; }
+    if(flags & 0x08) { flags &= ~0x08; return HDR_NAME; }
+    if(flags & 0x10) { flags &= ~0x10; return HDR_COMMENT; }
+    if(flags & 0x02) { flags &= ~0x02; return HDR_CRC; }
+    return HDR_DONE;
+}
+
+bool GunzipWriter::begin(ImageFile &out) {
+    end();
+    _st = (State*)(imageInPsram() ? ps_malloc(sizeof(State)) : malloc(sizeof(State)));
+    if(!_st) return false;
+    memset(_st, 0, sizeof(State));
+    tinfl_init(&_st->inflater);
+    _st->status = TINFL_STATUS_NEEDS_MORE_INPUT;
+    _out = &out;
+    return true;
+}
+
+void GunzipWriter::end() {
+    free(_st);
+    _st = nullptr;
+    _out = nullptr;
+}
+
+bool GunzipWriter::parseHeader(uint8_t c) {
+    State &s = *_st;
+    switch(s.step) {
+        case HDR_FIXED:
+            // Magic, method 8 (deflate), no reserved flags
+            if((s.count == 0 && c != 0x1F) || (s.count == 1 && c != 0x8B) || (s.count == 2 && c != 8)) return false;
+            if(s.count == 3) {
+                if(c & 0xE0) return false;
+                s.flags = c;
+            }
+            if(++s.count == 10) { s.count = 0; s.step = nextStep(s.flags); }
+            break;
+        case HDR_EXTRA_LEN:
+            s.extra |= c << (8 * s.count);
+            if(++s.count == 2) { s.count = 0; s.step = s.extra ? HDR_EXTRA : nextStep(s.flags); }
+            break;
+        case HDR_EXTRA:
+            if(--s.extra == 0) s.step = nextStep(s.flags);
+            break;
+        case HDR_NAME:
+        case HDR_COMMENT:
+            if(c == 0) s.step = nextStep(s.flags);
+            break;
+        case HDR_CRC:
+            if(++s.count == 2) { s.count = 0; s.step = nextStep(s.flags); }
+            break;
+    }
+    return true;
+}
+
+bool GunzipWriter::write(const uint8_t* data, size_t len) {
+    if(!_st) return false;
+    State &s = *_st;
+
+    if(len >= sizeof(s.tail)) {
+        memcpy(s.tail, data + len - sizeof(s.tail), sizeof(s.tail));
+    } else {
+        memmove(s.tail, s.tail + len, sizeof(s.tail) - len);
+        memcpy(s.tail + sizeof(s.tail) - len, data, len);
+    }
+
+    while(len && s.step != HDR_DONE) {
+        if(!parseHeader(*data)) return false;
+        data++;
+        len--;
+    }
+
+    // Bytes behind the deflate stream are the trailer (see tail)
+    while(!s.inflated && (len > 0 || s.status == TINFL_STATUS_HAS_MORE_OUTPUT)) {
+        size_t inBytes = len;
+        size_t outBytes = TINFL_LZ_DICT_SIZE - s.windowPos;
+        s.status = tinfl_decompress(&s.inflater, data, &inBytes, s.window, s.window + s.windowPos, &outBytes,
+                                    TINFL_FLAG_HAS_MORE_INPUT);
+        data += inBytes;
+        len -= inBytes;
+        if(outBytes) {
+            if(_out->write(s.window + s.windowPos, outBytes) != outBytes) return false;
+            s.crc = crc32_update(s.crc, s.window + s.windowPos, outBytes);
+            s.size += outBytes;
+            s.windowPos = (s.windowPos + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+        }
+        if(s.status < 0) return false;
+        if(s.status == TINFL_STATUS_DONE) s.inflated = true;
+    }
+    return true;
+}
+
+bool GunzipWriter::finish() {
+    if(!_st) return false;
+    State &s = *_st;
+    uint32_t crc = 0, size = 0;
+    for(uint8_t i = 0; i < 4; i++) {
+        crc |= (uint32_t)s.tail[i] << (8 * i);
+        size |= (uint32_t)s.tail[4 + i] << (8 * i);
+    }
+    bool ok = s.inflated && crc == s.crc && size == s.size;
+    end();
+    return ok;
+}
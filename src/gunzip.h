@@ -0,0 +1,23 @@
+#pragma once
+#include <Arduino.h>
+#include "image_store.h"
+
+// --- GZIP UPLOAD ---
+// Inflates a gzip stream chunk by chunk into an image slot with the ROM
+// inflater (tinfl). Window and decoder state (~43 KB, PSRAM if present)
+// are only allocated while an upload runs.
+
+class GunzipWriter {
+public:
+    ~GunzipWriter() { end(); }
+    bool begin(ImageFile &out);
+    bool write(const uint8_t* data, size_t len); // false = corrupt stream or image full
+    bool finish();                               // false = truncated or CRC/size mismatch
+    void end();                                  // Frees the buffers
+private:
+    bool parseHeader(uint8_t c);
+
+    struct State;
+    State* _st = nullptr;
+    ImageFile* _out = nullptr;
+};
@@ -0,0 +1,85 @@
+#include "gzip.h"
+#include "crc32.h"
+
+// Length symbols 257..285 (RFC 1951, 3.2.5)
+static const uint16_t LEN_BASE[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                     35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t LEN_EXTRA[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                     3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const uint16_t MAX_MATCH = 258;
+
+void GzipEncoder::putBits(uint32_t value, uint8_t count) {
+    _bits |= value << _bitCount;
+    _bitCount += count;
+    while(_bitCount >= 8) {
+        _out[_outLen++] = _bits & 0xFF;
+        _bits >>= 8;
+        _bitCount -= 8;
+    }
+}
+
+// Fixed literal/length code, Huffman codes are sent MSB first
+void GzipEncoder::putSymbol(uint16_t sym) {
+    uint16_t code;
+    uint8_t len;
+    if(sym < 144)      { code = 0x30 + sym;          len = 8; }
+    else if(sym < 256) { code = 0x190 + (sym - 144); len = 9; }
+    else if(sym < 280) { code = sym - 256;           len = 7; }
+    else               { code = 0xC0 + (sym - 280);  len = 8; }
+    uint16_t rev = 0;
+    for(uint8_t i = 0; i < len; i++) rev |= ((code >> i) & 1) << (len - 1 - i);
+    putBits(rev, len);
+}
+
+// Emits the pending repeats of _last: match (distance 1) or literals if too short
+void GzipEncoder::flushRun() {
+    if(_run >= 3) {
+        uint8_t i = 0;
+        while(i < 28 && LEN_BASE[i + 1] <= _run) i++;
+        putSymbol(257 + i);
+        if(LEN_EXTRA[i]) putBits(_run - LEN_BASE[i], LEN_EXTRA[i]);
+        putBits(0, 5); // Distance code 0 = 1 byte back
+    } else {
+        while(_run) { putSymbol(_last); _run--; }
+    }
+    _run = 0;
+}
+
+void GzipEncoder::begin() {
+    static const uint8_t HEADER[10] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF }; // Deflate, no mtime, OS unknown
+    memcpy(_out + _outLen, HEADER, sizeof(HEADER));
+    _outLen += sizeof(HEADER);
+    putBits(1, 1); // BFINAL: one block for the whole stream
+    putBits(1, 2); // BTYPE 01: fixed Huffman codes
+    _started = true;
+}
+
+size_t GzipEncoder::write(const uint8_t* data, size_t len, uint8_t* out) {
+    _out = out;
+    _outLen = 0;
+    if(!_started) begin();
+    _crc = crc32_update(_crc, data, len);
+    _size += len;
+    for(size_t i = 0; i < len; i++) {
+        if(data[i] == _last) {
+            if(++_run == MAX_MATCH) flushRun();
+            continue;
+        }
+        flushRun();
+        putSymbol(data[i]);
+        _last = data[i];
+    }
+    return _outLen;
+}
+
+size_t GzipEncoder::finish(uint8_t* out) {
+    _out = out;
+    _outLen = 0;
+    if(!_started) begin();
+    flushRun();
+    putSymbol(256); // End of block
+    if(_bitCount) putBits(0, 8 - _bitCount);
+    for(uint8_t i = 0; i < 4; i++) _out[_outLen++] = _crc >> (8 * i);
+    for(uint8_t i = 0; i < 4; i++) _out[_outLen++] = _size >> (8 * i);
+    return _outLen;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <Arduino.h>
+
+// --- GZIP ENCODER ---
+// Streaming gzip (RFC 1952) with a single fixed-Huffman deflate block and
+// run-length matches only (distance 1). No window, no tables: the state is
+// a few bytes, so it runs on the job task stack. Erased flash (0xFF runs)
+// shrinks to ~13 bits per 258 bytes, other data grows by at most 1/8.
+
+// Worst-case output of one write() of len bytes, finish() included
+#define GZIP_BOUND(len) ((len) + (len) / 8 + 32)
+
+class GzipEncoder {
+public:
+    // Output goes to out (at least GZIP_BOUND(len) bytes), returns the byte count
+    size_t write(const uint8_t* data, size_t len, uint8_t* out);
+    size_t finish(uint8_t* out);         // End of block + CRC/size trailer
+
+    uint32_t inputSize() const { return _size; }
+private:
+    void putBits(uint32_t value, uint8_t count);
+    void putSymbol(uint16_t sym);
+    void flushRun();
+    void begin();
+
+    uint8_t* _out = nullptr;
+    size_t _outLen = 0;
+    uint32_t _bits = 0;
+    uint8_t _bitCount = 0;
+    bool _started = false;
+    int16_t _last = -1;        // Previous input byte (-1 = none)
+    uint16_t _run = 0;         // Repeats of _last not yet emitted
+    uint32_t _crc = 0;
+    uint32_t _size = 0;
+};
@@ -0,0 +1,123 @@
+#include "halt_watch.h"
+#include "cc_interface.h"
+#include "flasher_controller.h"
+#include "breakpoints.h"
+
+static TaskHandle_t watchTask = NULL;
+static volatile bool watchActive = false;
+static volatile bool watchKicked = false;
+static volatile uint16_t watchHz = HALT_WATCH_DEFAULT_HZ;
+static HaltWatchStats stats = {};
+
+// Last published snapshot; the spinlock keeps bytes and length consistent for readers
+static uint8_t published[DBG_SNAPSHOT_SIZE];
+static size_t publishedLen = 0;
+static volatile uint32_t publishedSeq = 0;
+static portMUX_TYPE publishMux = portMUX_INITIALIZER_UNLOCKED;
+
+static void publish(const uint8_t* snap, size_t len) {
+    portENTER_CRITICAL(&publishMux);
+    memcpy(published, snap, len);
+    publishedLen = len;
+    publishedSeq++;
+    portEXIT_CRITICAL(&publishMux);
+    stats.events++;
+}
+
+static uint32_t backoff(uint32_t interval, uint32_t base, uint32_t limit) {
+    interval = (interval < base) ? base : interval * 2;
+    return (interval > limit) ? limit : interval;
+}
+
+void task_HaltWatch(void * parameter) {
+    uint8_t last = 0;          // Status byte of the last published snapshot
+    bool known = false;        // false = publish whatever the next poll sees
+    uint32_t interval = 1;
+    uint32_t lastChange = 0;
+
+    for(;;) {
+        if(!watchActive) {
+            known = false;
+            stats.intervalMs = 0;
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // Woken by haltWatchSetActive()
+            continue;
+        }
+        uint32_t base = 1000 / watchHz;
+        bool kicked = watchKicked;
+        if(kicked) watchKicked = false;
+
+        if(!tryLinkPoll()) {
+            // A job owns the link: the state afterwards is published again
+            known = false;
+            interval = backoff(interval, base, HALT_WATCH_BACKOFF_MS);
+        } else {
+            uint8_t snap[DBG_SNAPSHOT_SIZE];
+            snap[0] = cc.get_status_byte();
+            stats.polls++;
+            // Conditional breakpoint with a false condition: resumed already, nothing to publish
+            if(cpuHalted(snap[0]) && bpFilterHit()) snap[0] = cc.get_status_byte();
+            bool changed = !known || kicked || snap[0] != last;
+            size_t len = 1;
+            if(changed && cpuHalted(snap[0])) len = readSnapshot(snap);
+            endLinkPoll();
+
+            if(changed) {
+                publish(snap, len);
+                last = snap[0];
+                known = true;
+                lastChange = millis();
+            }
+            if(snap[0] == 0xFF) interval = backoff(interval, base, HALT_WATCH_BACKOFF_MS); // No target
+            else if(cpuHalted(snap[0])) interval = HALT_WATCH_HALTED_MS;
+            else if(millis() - lastChange > HALT_WATCH_FAST_MS && !bpConditionsArmed()) interval = backoff(interval, base, HALT_WATCH_QUIET_MS);
+            else interval = base;
+        }
+        stats.intervalMs = interval;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(interval)); // A kick ends the wait early
+    }
+}
+
+void initHaltWatch() {
+    if(watchTask) return;
+    xTaskCreate(task_HaltWatch, "HaltWatch", 4096, NULL, 1, &watchTask);
+}
+
+void haltWatchSetActive(bool on) {
+    if(on == watchActive) return;
+    watchActive = on;
+    if(watchTask) xTaskNotifyGive(watchTask);
+}
+
+void haltWatchSetHz(uint16_t hz) {
+    if(hz < 1) hz = 1;
+    if(hz > HALT_WATCH_MAX_HZ) hz = HALT_WATCH_MAX_HZ;
+    watchHz = hz;
+    haltWatchKick();
+}
+
+void haltWatchKick() {
+    watchKicked = true;
+    if(watchTask && watchActive) xTaskNotifyGive(watchTask);
+}
+
+uint32_t haltWatchSeq() {
+    return publishedSeq;
+}
+
+size_t haltWatchState(uint8_t* snap) {
+    portENTER_CRITICAL(&publishMux);
+    size_t len = publishedLen;
+    memcpy(snap, published, len);
+    portEXIT_CRITICAL(&publishMux);
+    return len;
+}
+
+HaltWatchStats haltWatchStats() {
+    return stats;
+}
+
+size_t formatHaltWatchJSON(char* buf, size_t len) {
+    return snprintf(buf, len, "{\"active\":%s,\"hz\":%u,\"interval_ms\":%lu,\"polls\":%lu,\"events\":%lu}",
+                    watchActive ? "true" : "false", (unsigned)watchHz, (unsigned long)stats.intervalMs,
+                    (unsigned long)stats.polls, (unsigned long)stats.events);
+}
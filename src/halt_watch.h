@@ -0,0 +1,40 @@
+#pragma once
+#include <Arduino.h>
+#include "debug_channel.h"
+
+// --- HALT WATCH ---
+// Background task that polls the debug status byte while debugger clients
+// are connected, so a breakpoint hit is seen within milliseconds instead of
+// on the next browser poll, and N open tabs cost one poll instead of N.
+// Every change of the CPU state is published as a snapshot (layout of
+// debug_channel.h: status alone while running, registers once halted)
+// with a sequence number; main.cpp forwards it from loop().
+//
+// Poll interval: 1/hz right after a state change or command, doubled up to
+// HALT_WATCH_QUIET_MS while nothing changes (after HALT_WATCH_FAST_MS).
+// While halted, without target (0xFF) or during a job the task backs off.
+// With conditional breakpoints set the task also runs without debugger
+// clients and keeps the full rate: it evaluates their hits (bpFilterHit).
+
+const uint16_t HALT_WATCH_DEFAULT_HZ = 1000;
+const uint16_t HALT_WATCH_MAX_HZ = 1000;      // One FreeRTOS tick
+const uint32_t HALT_WATCH_FAST_MS = 1000;     // Full rate after a change
+const uint32_t HALT_WATCH_QUIET_MS = 16;      // Longest interval while running
+const uint32_t HALT_WATCH_HALTED_MS = 100;    // Halted: only a reset or a command changes it
+const uint32_t HALT_WATCH_BACKOFF_MS = 500;   // Longest interval without target / link
+
+void initHaltWatch();                // Starts the task
+void haltWatchSetActive(bool on);    // Poll only while someone listens
+void haltWatchSetHz(uint16_t hz);    // 1..HALT_WATCH_MAX_HZ
+void haltWatchKick();                // Target changed by a command: publish a fresh snapshot now
+
+uint32_t haltWatchSeq();             // Changes with every published snapshot (0 = none yet)
+size_t haltWatchState(uint8_t* snap); // Last snapshot (DBG_SNAPSHOT_SIZE bytes), returns its length
+
+struct HaltWatchStats {
+    uint32_t polls;
+    uint32_t events;
+    uint32_t intervalMs;             // Current poll interval (0 = idle)
+};
+HaltWatchStats haltWatchStats();
+size_t formatHaltWatchJSON(char* buf, size_t len);
@@ -0,0 +1,213 @@
+#include "image_store.h"
+
+static const char* SLOT_PATH[] = { "/firmware.bin", "/dump.bin.gz" };
+
+struct PsramSlot {
+    uint8_t* data;
+    uint32_t len;
+    bool valid;
+};
+
+static bool usePsram = false;
+static PsramSlot slots[2] = {};
+
+void initImageStore() {
+    usePsram = psramFound();
+    if(LittleFS.exists("/dump.bin")) LittleFS.remove("/dump.bin"); // Uncompressed dump of older versions
+    if(!usePsram) return;
+    // Leftovers of a LittleFS build would only waste space
+    for(const char* path : SLOT_PATH) {
+        if(LittleFS.exists(path)) LittleFS.remove(path);
+    }
+}
+
+bool imageInPsram() {
+    return usePsram;
+}
+
+bool imageExists(ImageSlot slot) {
+    return usePsram ? slots[slot].valid : LittleFS.exists(SLOT_PATH[slot]);
+}
+
+void imageRemove(ImageSlot slot) {
+    if(usePsram) { slots[slot].valid = false; slots[slot].len = 0; }
+    else if(LittleFS.exists(SLOT_PATH[slot])) LittleFS.remove(SLOT_PATH[slot]);
+}
+
+const uint8_t* imageMemory(ImageSlot slot, size_t &len) {
+    len = 0;
+    if(!usePsram || !slots[slot].valid) return nullptr;
+    len = slots[slot].len;
+    return slots[slot].data;
+}
+
+// --- IMAGE FILE ---
+
+bool ImageFile::open(ImageSlot slot, const char* mode) {
+    close();
+    _slot = slot;
+    _write = (mode[0] == 'w');
+    _pos = 0;
+    _overflow = false;
+    _gzip = !usePsram && slot == IMG_DUMP;
+
+    if(!usePsram) {
+        if(_gzip && !_write) return false; // Compressed, see DumpReader
+        if(_write) imageRemove(slot);
+        if(_gzip) _gz = GzipEncoder();
+        _file = LittleFS.open(SLOT_PATH[slot], _write ? "w" : "r");
+        _open = (bool)_file;
+        return _open;
+    }
+
+    PsramSlot &s = slots[slot];
+    if(_write) {
+        // Allocated once and kept: no fragmentation of the PSRAM heap
+        if(!s.data) s.data = (uint8_t*)ps_malloc(IMAGE_SLOT_SIZE);
+        if(!s.data) return false;
+        s.valid = false;
+        s.len = 0;
+    } else if(!s.valid) {
+        return false;
+    }
+    _mem = s.data;
+    _open = true;
+    return true;
+}
+
+size_t ImageFile::read(uint8_t* buf, size_t len) {
+    if(!_open) return 0;
+    if(!_mem) return _file.read(buf, len);
+    uint32_t end = slots[_slot].len;
+    if(_pos >= end) return 0;
+    if(len > end - _pos) len = end - _pos;
+    memcpy(buf, _mem + _pos, len);
+    _pos += len;
+    return len;
+}
+
+size_t ImageFile::write(const uint8_t* buf, size_t len) {
+    if(!_open || !_write) return 0;
+    if(_gzip) {
+        writeGzip(buf, len, false);
+        return _overflow ? 0 : len;
+    }
+    if(!_mem) {
+        size_t n = _file.write(buf, len);
+        if(n != len) _overflow = true; // LittleFS full
+        return n;
+    }
+    if(_pos >= IMAGE_SLOT_SIZE || len > IMAGE_SLOT_SIZE - _pos) { _overflow = true; return 0; }
+    memcpy(_mem + _pos, buf, len);
+    _pos += len;
+    if(_pos > slots[_slot].len) slots[_slot].len = _pos;
+    return len;
+}
+
+void ImageFile::writeGzip(const uint8_t* buf, size_t len, bool final) {
+    uint8_t out[GZIP_BOUND(256)];
+    for(size_t off = 0; off < len; off += 256) {
+        size_t n = _gz.write(buf + off, (len - off < 256) ? len - off : 256, out);
+        if(_file.write(out, n) != n) _overflow = true;
+    }
+    if(final) {
+        size_t n = _gz.finish(out);
+        if(_file.write(out, n) != n) _overflow = true;
+    }
+}
+
+bool ImageFile::seek(uint32_t pos) {
+    if(!_open) return false;
+    if(_gzip) return false;
+    if(!_mem) return _file.seek(pos);
+    if(pos > slots[_slot].len) return false;
+    _pos = pos;
+    return true;
+}
+
+size_t ImageFile::size() {
+    if(!_open) return 0;
+    if(_gzip) return _gz.inputSize();
+    return _mem ? slots[_slot].len : _file.size();
+}
+
+int ImageFile::available() {
+    if(!_open) return 0;
+    return _mem ? (int)(slots[_slot].len - _pos) : _file.available();
+}
+
+void ImageFile::close() {
+    if(!_open) return;
+    if(_mem) {
+        if(_write) slots[_slot].valid = !_overflow;
+    } else {
+        if(_gzip && _write) writeGzip(nullptr, 0, true);
+        _file.close();
+        if(_write && _overflow) imageRemove(_slot);
+    }
+    _mem = nullptr;
+    _open = false;
+    _gzip = false;
+}
+
+void ImageFile::discard() {
+    if(!_open) return;
+    if(_write) _overflow = true;
+    close();
+}
+
+// --- DUMP READER ---
+
+static volatile uint8_t dumpReaders = 0;
+
+bool dumpReaderActive() {
+    return dumpReaders != 0;
+}
+
+DumpReader::DumpReader(bool gzip) : _gzip(gzip) {
+    dumpReaders++;
+    if(usePsram) {
+        _mem = imageMemory(IMG_DUMP, _memLen);
+        _ok = _mem != nullptr;
+    } else if(gzip && LittleFS.exists(SLOT_PATH[IMG_DUMP])) {
+        _file = LittleFS.open(SLOT_PATH[IMG_DUMP], "r");
+        _ok = (bool)_file;
+    }
+}
+
+DumpReader::~DumpReader() {
+    if(_file) _file.close();
+    dumpReaders--;
+}
+
+size_t DumpReader::read(uint8_t* buf, size_t maxLen) {
+    if(!_ok) return 0;
+    if(!_mem) return _file.read(buf, maxLen);
+    if(!_gzip) {
+        size_t n = (_memLen - _memPos < maxLen) ? _memLen - _memPos : maxLen;
+        memcpy(buf, _mem + _memPos, n);
+        _memPos += n;
+        return n;
+    }
+    size_t done = 0;
+    while(done < maxLen) {
+        if(_outPos == _outLen) {
+            if(_finished) break;
+            _outPos = 0;
+            if(_memPos < _memLen) {
+                size_t n = (_memLen - _memPos < 512) ? _memLen - _memPos : 512;
+                _outLen = _gz.write(_mem + _memPos, n, _out);
+                _memPos += n;
+            } else {
+                _outLen = _gz.finish(_out);
+                _finished = true;
+            }
+            continue;
+        }
+        size_t n = (_outLen - _outPos < maxLen - done) ? _outLen - _outPos : maxLen - done;
+        memcpy(buf + done, _out + _outPos, n);
+        _outPos += n;
+        done += n;
+    }
+    return done;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "gzip.h"
+
+// --- IMAGE STORE ---
+// Uploaded firmware and the last dump. On boards with PSRAM both live in a
+// PSRAM arena (one slot each, allocated on first use), so jobs run
+// memory-to-link and images may exceed the free LittleFS space. Without
+// PSRAM the slots are the files /firmware.bin and /dump.bin.gz: the dump is
+// stored gzip-compressed (erased pages cost a few bytes) and can only be
+// streamed out again (DumpReader), not read back through ImageFile.
+// Note: a PSRAM image does not survive a reboot, a flash checkpoint then
+// cannot be resumed.
+
+enum ImageSlot : uint8_t { IMG_FIRMWARE, IMG_DUMP };
+
+const uint32_t IMAGE_SLOT_SIZE = 262144; // Largest flash (CC2530F256)
+
+void initImageStore();                   // Decides PSRAM or LittleFS (call after LittleFS.begin)
+bool imageInPsram();
+bool imageExists(ImageSlot slot);
+void imageRemove(ImageSlot slot);
+
+// Contents of a PSRAM slot for zero-copy access (nullptr = no PSRAM or empty)
+const uint8_t* imageMemory(ImageSlot slot, size_t &len);
+
+bool dumpReaderActive();                 // A dump download is streaming from the slot
+
+// File-like access to a slot. A slot opened for writing becomes visible
+// (imageExists) on close(), unless a write did not fit (slot size, LittleFS
+// full) - a truncated image is never flashed.
+class ImageFile {
+public:
+    ~ImageFile() { close(); }
+    bool open(ImageSlot slot, const char* mode = "r"); // "r" or "w"
+    size_t read(uint8_t* buf, size_t len);
+    size_t write(const uint8_t* buf, size_t len);
+    bool seek(uint32_t pos);
+    size_t size();
+    int available();
+    void close();
+    void discard();                      // Closes a slot opened for writing without publishing it
+    operator bool() const { return _open; }
+private:
+    File _file;
+    uint8_t* _mem = nullptr;
+    ImageSlot _slot = IMG_FIRMWARE;
+    uint32_t _pos = 0;
+    bool _open = false;
+    bool _write = false;
+    bool _overflow = false;
+    bool _gzip = false;                  // LittleFS dump: compressed on write
+    GzipEncoder _gz;
+    void writeGzip(const uint8_t* buf, size_t len, bool final);
+};
+
+// Dump download: gzip = true yields a gzip stream (as stored on LittleFS,
+// compressed on the fly from PSRAM), false the raw image (PSRAM only).
+// The dump slot must not be rewritten while a reader exists (dumpReaderActive).
+class DumpReader {
+public:
+    DumpReader(bool gzip);
+    ~DumpReader();
+    operator bool() const { return _ok; }
+    size_t read(uint8_t* buf, size_t maxLen); // 0 = end
+private:
+    bool _ok = false;
+    bool _gzip;
+    File _file;
+    const uint8_t* _mem = nullptr;
+    size_t _memLen = 0, _memPos = 0;
+    GzipEncoder _gz;
+    bool _finished = false;
+    uint8_t _out[GZIP_BOUND(512)];
+    size_t _outLen = 0, _outPos = 0;
+};
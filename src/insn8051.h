@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+
+// --- 8051 INSTRUCTION DECODER ---
+// Length and control flow class of every opcode, computed at compile time
+// (same instruction set as OPCODES in web_js.h). One byte per opcode:
+// bits 1:0 = length in bytes, bits 4:2 = InsnFlow.
+
+enum InsnFlow : uint8_t {
+    FLOW_NEXT,    // Falls through to the next instruction
+    FLOW_CALL,    // ACALL, LCALL: returns to PC + length
+    FLOW_RET,     // RET, RETI
+    FLOW_JUMP,    // AJMP, LJMP, SJMP, JMP @A+DPTR
+    FLOW_BRANCH,  // JC .. JNZ, JB, JNB, JBC, CJNE, DJNZ: jump or fall through
+    FLOW_TRAP,    // 0xA5: reserved opcode, halts the CPU while debugging
+};
+
+constexpr uint8_t insnLength(uint8_t op) {
+    return ((op & 0x0F) == 0x01) ? 2 :                                             // AJMP/ACALL
+           (op == 0x02 || op == 0x12 || op == 0x10 || op == 0x20 || op == 0x30 ||
+            op == 0x43 || op == 0x53 || op == 0x63 || op == 0x75 || op == 0x85 ||
+            op == 0x90 || op == 0xD5 || (op >= 0xB4 && op <= 0xBF)) ? 3 :
+           (op == 0x00 || op == 0xA5 || op == 0xE0 || op == 0xF0 ||
+            op == 0x22 || op == 0x32 || op == 0xE2 || op == 0xF2) ? 1 :
+           ((op & 0x0F) == 0x00 || (op & 0x0F) == 0x02) ? 2 :                      // Rel. jumps, bit ops, PUSH/POP
+           ((op & 0x0F) == 0x03) ? 1 :
+           ((op & 0x0F) == 0x04) ? ((op >= 0x24 && op <= 0x94 && op != 0x84) ? 2 : 1) :
+           ((op & 0x0F) == 0x05) ? 2 :                                             // ... direct
+           (op >= 0x76 && op <= 0x7F) || (op >= 0x86 && op <= 0x8F) ||
+           (op >= 0xA6 && op <= 0xAF) || (op >= 0xD8 && op <= 0xDF) ? 2 : 1;      // @Ri / Rn forms
+}
+
+constexpr InsnFlow insnFlow(uint8_t op) {
+    return ((op & 0x1F) == 0x11 || op == 0x12) ? FLOW_CALL :
+           (op == 0x22 || op == 0x32) ? FLOW_RET :
+           ((op & 0x1F) == 0x01 || op == 0x02 || op == 0x80 || op == 0x73) ? FLOW_JUMP :
+           ((op & 0x0F) == 0x00 && op >= 0x10 && op <= 0x70) || op == 0xD5 ||
+           (op >= 0xB4 && op <= 0xBF) || (op >= 0xD8 && op <= 0xDF) ? FLOW_BRANCH :
+           (op == 0xA5) ? FLOW_TRAP : FLOW_NEXT;
+}
+
+#define INSN_ENTRY(op) (uint8_t)(insnLength(op) | (insnFlow(op) << 2))
+#define INSN_ROW(hi) INSN_ENTRY(hi + 0x0), INSN_ENTRY(hi + 0x1), INSN_ENTRY(hi + 0x2), INSN_ENTRY(hi + 0x3), \
+                     INSN_ENTRY(hi + 0x4), INSN_ENTRY(hi + 0x5), INSN_ENTRY(hi + 0x6), INSN_ENTRY(hi + 0x7), \
+                     INSN_ENTRY(hi + 0x8), INSN_ENTRY(hi + 0x9), INSN_ENTRY(hi + 0xA), INSN_ENTRY(hi + 0xB), \
+                     INSN_ENTRY(hi + 0xC), INSN_ENTRY(hi + 0xD), INSN_ENTRY(hi + 0xE), INSN_ENTRY(hi + 0xF)
+
+constexpr uint8_t INSN_TABLE[256] = {
+    INSN_ROW(0x00), INSN_ROW(0x10), INSN_ROW(0x20), INSN_ROW(0x30),
+    INSN_ROW(0x40), INSN_ROW(0x50), INSN_ROW(0x60), INSN_ROW(0x70),
+    INSN_ROW(0x80), INSN_ROW(0x90), INSN_ROW(0xA0), INSN_ROW(0xB0),
+    INSN_ROW(0xC0), INSN_ROW(0xD0), INSN_ROW(0xE0), INSN_ROW(0xF0),
+};
+
+#undef INSN_ROW
+#undef INSN_ENTRY
+
+static_assert(insnLength(0x12) == 3 && insnLength(0x11) == 2 && insnLength(0x90) == 3, "call / DPTR length");
+static_assert(insnLength(0xB4) == 3 && insnLength(0xD8) == 2 && insnLength(0x84) == 1, "CJNE / DJNZ / DIV length");
+static_assert(insnFlow(0x31) == FLOW_CALL && insnFlow(0x21) == FLOW_JUMP && insnFlow(0xD5) == FLOW_BRANCH, "flow");
+
+inline uint8_t insnTableLength(uint8_t op) { return INSN_TABLE[op] & 0x03; }
+inline InsnFlow insnTableFlow(uint8_t op) { return (InsnFlow)(INSN_TABLE[op] >> 2); }
@@ -0,0 +1,180 @@
+#include "link_trace.h"
+#include <stdarg.h>
+#include <stdlib.h>
+
+volatile bool traceEnabled = false;
+
+static TraceFrame* ring = nullptr;
+static uint16_t ringDepth = 0;
+static volatile uint16_t head = 0;     // Next slot to write
+static volatile uint16_t stored = 0;   // Valid frames (<= ringDepth)
+static volatile uint32_t recorded = 0; // Frames since traceStart()
+static volatile uint8_t readers = 0;
+
+static const struct { uint8_t cmd; const char* name; } COMMANDS[] = {
+    { 0x14, "CHIP_ERASE" }, { 0x1D, "WR_CONFIG" }, { 0x24, "RD_CONFIG" }, { 0x28, "GET_PC" },
+    { 0x34, "READ_STATUS" }, { 0x3F, "SET_HW_BRKPNT" }, { 0x44, "HALT" }, { 0x4C, "RESUME" },
+    { 0x5C, "STEP_INSTR" }, { 0x68, "GET_CHIP_ID" }
+};
+
+bool traceStart(uint16_t depth) {
+    if(readers) return false;
+    if(depth == 0 || depth > TRACE_MAX_DEPTH) depth = TRACE_DEFAULT_DEPTH;
+    traceEnabled = false;
+    if(depth != ringDepth) {
+        free(ring);
+        ring = (TraceFrame*)malloc(depth * sizeof(TraceFrame));
+        ringDepth = ring ? depth : 0;
+        if(!ring) return false;
+    }
+    head = 0;
+    stored = 0;
+    recorded = 0;
+    traceEnabled = true;
+    return true;
+}
+
+void traceStop() {
+    traceEnabled = false;
+}
+
+void traceRecord(uint32_t start, const uint8_t* tx, uint8_t txLen, uint16_t rx, uint8_t rxLen) {
+    if(!ring) return;
+    TraceFrame &f = ring[head];
+    f.cycles = start;
+    f.duration = ESP.getCycleCount() - start;
+    f.ms = millis();
+    memcpy(f.tx, tx, txLen);
+    f.txLen = txLen;
+    f.rx = rx;
+    f.rxLen = rxLen;
+    head = (head + 1 < ringDepth) ? head + 1 : 0;
+    if(stored < ringDepth) stored++;
+    recorded++;
+}
+
+size_t formatTraceJSON(char* buf, size_t len) {
+    int n = snprintf(buf, len, "{\"enabled\":%s,\"depth\":%u,\"frames\":%u,\"recorded\":%lu,\"cpu_mhz\":%lu}",
+                     traceEnabled ? "true" : "false", ringDepth, stored, (unsigned long)recorded,
+                     (unsigned long)ESP.getCpuFreqMHz());
+    return (n < 0) ? 0 : ((size_t)n < len ? n : len - 1);
+}
+
+// --- EXPORT ---
+
+TraceReader::TraceReader(TraceFormat format) : _format(format), _wasEnabled(traceEnabled) {
+    traceEnabled = false;
+    readers++;
+}
+
+TraceReader::~TraceReader() {
+    readers--;
+    if(_wasEnabled) traceEnabled = true;
+}
+
+void TraceReader::append(const char* format, ...) {
+    if(_len >= sizeof(_text)) return;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(_text + _len, sizeof(_text) - _len, format, args);
+    va_end(args);
+    if(n > 0) _len += ((size_t)n < sizeof(_text) - _len) ? n : sizeof(_text) - _len - 1;
+}
+
+size_t TraceReader::read(uint8_t* buf, size_t maxLen) {
+    size_t written = 0;
+    while(written < maxLen) {
+        if(_pos >= _len) {
+            _len = _pos = 0;
+            renderNext();
+            if(_len == 0) break; // All frames exported
+        }
+        size_t n = _len - _pos;
+        if(n > maxLen - written) n = maxLen - written;
+        memcpy(buf + written, _text + _pos, n);
+        _pos += n;
+        written += n;
+    }
+    return written;
+}
+
+void TraceReader::renderNext() {
+    uint32_t mhz = ESP.getCpuFreqMHz();
+    if(_header) {
+        _header = false;
+        if(_format == TRACE_VCD) {
+            append("$version ESP32 CC-Tool debug link trace $end\n$timescale 1ns $end\n"
+                   "$scope module cc_debug $end\n$var wire 1 c DC $end\n$var wire 1 d DD $end\n"
+                   "$var wire 1 r DD_TARGET $end\n$var wire 8 b BYTE $end\n$upscope $end\n"
+                   "$enddefinitions $end\n#0\n$dumpvars\n0c\n1d\n0r\nb0 b\n$end\n");
+        } else {
+            append("# %u frames (%lu recorded), CPU %lu MHz\n# idx     t_us       dur_us  frame -> response\n",
+                   stored, (unsigned long)recorded, (unsigned long)mhz);
+        }
+        return;
+    }
+    if(_index >= stored) return;
+
+    const TraceFrame &f = ring[(head + ringDepth - stored + _index) % ringDepth];
+    // Frame distance from CCOUNT, from millis() if CCOUNT may have wrapped
+    if(_index > 0) {
+        uint32_t dMs = f.ms - _prevMs;
+        _timeNs += (dMs > 10000) ? (uint64_t)dMs * 1000000ULL
+                                 : (uint64_t)(uint32_t)(f.cycles - _prevCycles) * 1000 / mhz;
+    }
+    if(_timeNs < _endNs) _timeNs = _endNs; // Keep the waveform monotonic
+    _prevCycles = f.cycles;
+    _prevMs = f.ms;
+
+    if(_format == TRACE_VCD) renderVCD(f);
+    else renderLog(f);
+    _index++;
+}
+
+void TraceReader::renderLog(const TraceFrame &f) {
+    uint32_t mhz = ESP.getCpuFreqMHz();
+    append("%5lu %12.2f %9.2f  ", (unsigned long)_index, _timeNs / 1000.0, (double)f.duration / mhz);
+
+    if(f.tx[0] >= 0x55 && f.tx[0] <= 0x57) {
+        append("INSTR");
+        for(uint8_t i = 1; i < f.txLen; i++) append(" %02X", f.tx[i]);
+    } else {
+        const char* name = nullptr;
+        for(const auto &c : COMMANDS) if(c.cmd == f.tx[0]) name = c.name;
+        if(name) append("%s", name); else append("CMD %02X", f.tx[0]);
+        for(uint8_t i = 1; i < f.txLen; i++) append(" %02X", f.tx[i]);
+    }
+    if(f.rxLen == 2) append(" -> %04X\n", f.rx);
+    else append(" -> %02X\n", f.rx & 0xFF);
+}
+
+// Bit level waveform. Only the frame start and length are measured, the
+// bits are spread evenly over the frame.
+void TraceReader::renderVCD(const TraceFrame &f) {
+    uint8_t bytes[6];
+    uint8_t n = 0;
+    for(uint8_t i = 0; i < f.txLen; i++) bytes[n++] = f.tx[i];
+    if(f.rxLen == 2) bytes[n++] = f.rx >> 8;
+    bytes[n++] = f.rx & 0xFF;
+
+    uint64_t bitNs = (uint64_t)f.duration * 1000 / ESP.getCpuFreqMHz() / (n * 8);
+    if(bitNs < 2) bitNs = 2;
+    uint64_t t = _timeNs;
+
+    for(uint8_t i = 0; i < n; i++) {
+        uint8_t dir = (i >= f.txLen) ? 1 : 0;
+        append("#%llu\nb", (unsigned long long)t);
+        for(int8_t b = 7; b >= 0; b--) append("%c", ((bytes[i] >> b) & 1) ? '1' : '0');
+        append(" b\n");
+        if(dir != _dir) { _dir = dir; append("%ur\n", dir); }
+
+        for(int8_t b = 7; b >= 0; b--) {
+            uint8_t dd = (bytes[i] >> b) & 1;
+            if(b < 7) append("#%llu\n", (unsigned long long)t); // Bit 7 shares the byte timestamp
+            if(dd != _dd) { _dd = dd; append("%ud\n", dd); }
+            append("1c\n#%llu\n0c\n", (unsigned long long)(t + bitNs / 2));
+            t += bitNs;
+        }
+    }
+    _endNs = t;
+}
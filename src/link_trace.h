@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+
+// --- DEBUG LINK TRACE ---
+// Optional ring buffer of the last frames on the debug link (command or
+// DEBUG_INSTR bytes, response, CCOUNT timestamp). CC_interface only tests
+// traceEnabled per frame, so a disabled tracer costs a single branch.
+// Recording stops by itself when a job fails, the ring then holds the
+// frames that led to the error.
+
+struct TraceFrame {
+    uint32_t cycles;     // CCOUNT at frame start
+    uint32_t duration;   // Frame length in CPU cycles
+    uint32_t ms;         // millis() at frame end (CCOUNT wraps after ~17 s)
+    uint8_t tx[4];       // Command byte + up to 3 instruction bytes
+    uint16_t rx;         // Response (1 or 2 bytes)
+    uint8_t txLen;
+    uint8_t rxLen;
+};
+
+extern volatile bool traceEnabled;
+
+const uint16_t TRACE_DEFAULT_DEPTH = 1024;
+const uint16_t TRACE_MAX_DEPTH = 8192;
+
+// (Re)allocates and clears the ring and starts recording
+// Returns: false = out of memory or an export is running
+bool traceStart(uint16_t depth = TRACE_DEFAULT_DEPTH);
+void traceStop();   // Keeps the recorded frames for export
+
+void traceRecord(uint32_t start, const uint8_t* tx, uint8_t txLen, uint16_t rx, uint8_t rxLen);
+
+size_t formatTraceJSON(char* buf, size_t len);
+
+// Incremental export for chunked HTTP responses.
+// Recording pauses while a reader exists.
+enum TraceFormat : uint8_t { TRACE_LOG, TRACE_VCD };
+
+class TraceReader {
+public:
+    TraceReader(TraceFormat format);
+    ~TraceReader();
+    size_t read(uint8_t* buf, size_t maxLen); // 0 = end
+private:
+    void renderNext();
+    void renderLog(const TraceFrame &f);
+    void renderVCD(const TraceFrame &f);
+    void append(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    TraceFormat _format;
+    bool _wasEnabled;
+    bool _header = true;
+    uint32_t _index = 0;       // Next frame (0 = oldest)
+    uint32_t _prevCycles = 0, _prevMs = 0;
+    uint64_t _timeNs = 0;      // Start of the current frame, relative to the oldest
+    uint64_t _endNs = 0;       // End of the last rendered waveform
+    uint8_t _dd = 1, _dir = 0;
+    char _text[3072];
+    size_t _len = 0, _pos = 0;
+};
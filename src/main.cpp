@@ -4,11 +4,23 @@
 #include <LittleFS.h>
 #include <ESPmDNS.h>
 #include <Preferences.h> 
+#include <memory>
 #include "cc_interface.h"
-#include "web_index.h" 
 #include "flasher_controller.h"
-#include "web_js.h"
-#include "web_lang.h"
+#include "image_store.h"
+#include "debug_channel.h"
+#include "halt_watch.h"
+#include "run_control.h"
+#include "breakpoints.h"
+#include "gunzip.h"
+#include "web_assets_gz.h" // Generated from web_index.h, web_js.h, web_lang.h (tools/gzip_assets.py)
+#include "metrics.h"
+#include "bench.h"
+#include "profiler.h"
+#include "var_watch.h"
+#include "step_trace.h"
+#include "link_trace.h"
+#include "version.h"
 
 // --- HARDWARE CONFIG ---
 #define PIN_CC_CLK  4
@@ -20,11 +32,256 @@ const char* ap_ssid       = "ESP32-CC-Flasher";
 const char* ap_password   = "12345678";
 
 AsyncWebServer server(80);
+AsyncEventSource events("/api/events");
+AsyncWebSocket debugWs("/ws/debug"); // Binary debugger protocol (debug_channel.h)
+
+// Progress updates are coalesced to this interval (max. 25 events/s)
+const uint32_t EVENT_MIN_INTERVAL_MS = 40;
+const size_t STATUS_JSON_SIZE = 256;
+const size_t WATCH_EVENT_SIZE = 2048;     // Samples per "watch" event (as many as fit)
 
 // --- GLOBAL VARIABLES ---
 Preferences preferences; 
 bool isApMode = false;
 
+// Holds the debug link for the scope of a handler: the halt watch polls from its own task
+struct LinkGuard {
+    bool held;
+    LinkGuard() : held(acquireLink()) {}
+    ~LinkGuard() { if(held) releaseLink(); }
+};
+
+// Register snapshot (debug_channel.h layout) as JSON; only the status while the CPU runs
+String snapshotJSON(const uint8_t* snap, size_t len) {
+    String json = "{\"halted\":" + String(cpuHalted(snap[0])?"true":"false") + ",\"raw\":\"0x" + String(snap[0], HEX) + "\"";
+    if(len >= DBG_SNAPSHOT_SIZE) {
+        const char* names[] = { "ACC", "B", "PSW", "SP", "DPL", "DPH", "P0", "P1", "P2" };
+        json += ",\"PC\":\"0x" + String(snap[1] | (snap[2] << 8), HEX) + "\"";
+        for(int i=0; i<9; i++) json += ",\"" + String(names[i]) + "\":\"0x" + String(snap[3 + i], HEX) + "\"";
+        char dptr[8];
+        snprintf(dptr, sizeof(dptr), "0x%02x%02x", snap[8], snap[7]);
+        json += ",\"DPTR\":\"" + String(dptr) + "\"";
+
+        // R-Register Array
+        json += ",\"R\":[";
+        for(int i=0; i<8; i++) {
+            json += "\"0x" + String(snap[12 + i], HEX) + "\"";
+            if(i<7) json += ",";
+        }
+        json += "]";
+    }
+    return json + "}";
+}
+
+// Called from loop(): the halt watch polls while a debugger socket is open,
+// its state changes go to the sockets (binary) and SSE subscribers (JSON)
+void pumpDebugEvents() {
+    static uint32_t sentSeq = 0;
+    haltWatchSetActive(debugWs.count() > 0 || bpConditionsArmed());
+
+    uint32_t seq = haltWatchSeq();
+    if(seq == sentSeq) return;
+    sentSeq = seq;
+    uint8_t frame[3 + DBG_SNAPSHOT_SIZE] = { DBG_EVT_STATE, 0, DBG_OK };
+    size_t len = haltWatchState(frame + 3);
+    debugWs.binaryAll(frame, 3 + len);
+    if(events.count()) events.send(snapshotJSON(frame + 3, len).c_str(), "debug");
+}
+
+// HTTP fallback of the run control ops: same path as the debugger channel, answered with the snapshot JSON
+void runControl(AsyncWebServerRequest *r, uint8_t op, uint16_t addr = 0) {
+    uint8_t req[4] = { op, 0, (uint8_t)addr, (uint8_t)(addr >> 8) };
+    static uint8_t resp[DBG_RESPONSE_MAX]; // async_tcp task only, like the socket handler
+    size_t n = handleDebugRequest(req, sizeof(req), resp);
+    switch(resp[2]) {
+        case DBG_OK:         r->send(200, "application/json", snapshotJSON(resp + 3, n - 3)); haltWatchKick(); break;
+        case DBG_BUSY:       r->send(200, "text/plain", "BUSY"); break;
+        case DBG_NOT_HALTED: r->send(200, "text/plain", "NOT HALTED"); break;
+        case DBG_NO_RETURN:  r->send(200, "text/plain", "NO RETURN ADDRESS"); break;
+        case DBG_BP_FULL:    r->send(200, "text/plain", "BP FULL"); break;
+        default:             r->send(400, "text/plain", "Bad request"); break;
+    }
+}
+
+// Called from loop(): forwards controller changes as Server-Sent Events
+void pumpEvents() {
+    static uint32_t sentStatusSeq = 0;
+    static unsigned long lastSend = 0;
+
+    if(events.count() == 0) return;
+
+    uint32_t seq = getStatusSeq();
+    if(seq != sentStatusSeq && millis() - lastSend >= EVENT_MIN_INTERVAL_MS) {
+        char json[STATUS_JSON_SIZE];
+        formatStatusJSON(json, sizeof(json));
+        sentStatusSeq = seq;
+        lastSend = millis();
+        events.send(json, "status");
+    }
+}
+
+// Called from loop(): new samples of the variable watch as "watch" events (chart in the debugger)
+void pumpWatchEvents() {
+    static uint32_t sentSeq = 0;
+    static unsigned long lastSend = 0;
+    if(events.count() == 0 || millis() - lastSend < EVENT_MIN_INTERVAL_MS) return;
+    static char json[WATCH_EVENT_SIZE];
+    if(formatWatchSamples(json, sizeof(json), sentSeq) == 0) return;
+    lastSend = millis();
+    events.send(json, "watch");
+}
+
+// Streams the trace in chunks, recording pauses until the response is done
+void sendTrace(AsyncWebServerRequest *r, TraceFormat format) {
+    std::shared_ptr<TraceReader> reader = std::make_shared<TraceReader>(format);
+    AsyncWebServerResponse *res = r->beginChunkedResponse(format == TRACE_VCD ? "application/octet-stream" : "text/plain",
+        [reader](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+            return reader->read(buffer, maxLen);
+        });
+    if(format == TRACE_VCD) res->addHeader("Content-Disposition", "attachment; filename=cc_trace.vcd");
+    r->send(res);
+}
+
+// Memory read for /api/debug/mem.bin. Holds the debug link until the response
+// is destroyed (also on client disconnect), so no job can start in between.
+const size_t MEM_READ_STEP = 256; // Per callback: keeps the async TCP task responsive
+
+struct MemReader {
+    uint8_t space;
+    uint32_t addr, left;
+    MemReader(uint8_t space, uint32_t addr, uint32_t len) : space(space), addr(addr), left(len) {}
+    ~MemReader() { releaseLink(); }
+
+    size_t read(uint8_t *buffer, size_t maxLen) {
+        size_t n = maxLen < MEM_READ_STEP ? maxLen : MEM_READ_STEP;
+        if(n > left) n = left;
+        if(n == 0) return 0;
+        readTargetMemory(space, addr, n, buffer);
+        addr += n;
+        left -= n;
+        return n;
+    }
+};
+
+// Pre-compressed asset: 304 if the browser has this version. Versioned URLs
+// (?v=<hash>, set by tools/gzip_assets.py) never change and are cached for good.
+void sendAsset(AsyncWebServerRequest *r, const WebAsset &asset) {
+    if(r->hasHeader("If-None-Match") && r->header("If-None-Match") == asset.etag) {
+        AsyncWebServerResponse *res = r->beginResponse(304, asset.type, "");
+        res->addHeader("ETag", asset.etag);
+        r->send(res);
+        return;
+    }
+    AsyncWebServerResponse *res = r->beginResponse(200, asset.type, asset.data, asset.len);
+    res->addHeader("Content-Encoding", "gzip");
+    res->addHeader("ETag", asset.etag);
+    res->addHeader("Cache-Control", r->hasParam("v") ? "public, max-age=31536000, immutable" : "no-cache");
+    r->send(res);
+}
+
+String pinsJSON() {
+    String json = "{";
+    json += "\"clk\":" + String(PIN_CC_CLK) + ",";
+    json += "\"data\":" + String(PIN_CC_DATA) + ",";
+    json += "\"rst\":" + String(PIN_CC_RST);
+    json += "}";
+    return json;
+}
+
+String systemInfoJSON() {
+    String json = "{";
+    json += "\"ip\":\"" + (isApMode ? WiFi.softAPIP().toString() : WiFi.localIP().toString()) + "\",";
+    json += "\"mode\":\"" + String(isApMode ? "AP" : "STA") + "\",";
+    json += "\"fw\":\"" FW_VERSION "\",";
+    json += "\"store\":\"" + String(imageInPsram() ? "psram" : "fs") + "\"";
+    json += "}";
+    return json;
+}
+
+// Reads ID, info page, MAC and the first code bytes; the result is kept for /api/bootstrap during jobs
+String chipInfoCache;
+String chipInfoJSON() {
+    uint16_t raw_id = cc.send_cc_cmd(0x68);
+    uint8_t chip_id = (raw_id >> 8) & 0xFF; 
+    uint8_t chip_rev = raw_id & 0xFF;
+    
+    String modelName = "Unknown (0x" + String(chip_id, HEX) + ")";
+    String flashSize = "Unknown"; 
+    bool hasMac = true; 
+    bool isLocked = false;
+    
+    String rawDump = ""; 
+    uint8_t infoBuf[8]; 
+    bool allZeros = true;
+    
+    cc.WR_CONFIG(0x01); 
+    cc.read_xdata_memory(0x0000, 8, infoBuf); 
+    cc.WR_CONFIG(0x00); 
+    
+    for(int i=0; i<8; i++){ 
+        if(infoBuf[i] != 0x00) allZeros = false; 
+        if(infoBuf[i]<0x10) rawDump+="0"; 
+        rawDump+=String(infoBuf[i], HEX)+" "; 
+    }
+    rawDump.toUpperCase();
+
+    if((chip_id == 0x11 || chip_id == 0x01) && allZeros) {
+        isLocked = true;
+        flashSize = "Locked (Protected)";
+        modelName += " [LOCKED]";
+    }
+
+    if(chip_id == 0x01 || chip_id == 0x11) {
+        modelName = (chip_id == 0x11) ? "CC1111 (USB)" : "CC1110"; hasMac = false;
+        if(!isLocked) flashSize = String(cc.detect_flash_size() / 1024) + " KB (Detected)";
+    } else if(chip_id == 0xA5) { modelName = "CC2530"; hasMac = true; } 
+      else if(chip_id == 0xB5) { modelName = "CC2531"; hasMac = true; }
+
+    String macStr = "N/A (CC111x)";
+    if(hasMac && !isLocked) {
+        uint8_t mac[8]; cc.read_xdata_memory(0x7FF8, 8, mac);
+        macStr = ""; for(int i=0; i<8; i++) { if(mac[i]<0x10) macStr+="0"; macStr+=String(mac[i], HEX); if(i<7) macStr+=":"; }
+        macStr.toUpperCase();
+    }
+
+    String hexPreview = "";
+    if(!isLocked) {
+        uint8_t codeBuf[64];
+        cc.read_code_memory(0x0000, 64, codeBuf);
+        for(int i=0; i<64; i++) {
+            if(codeBuf[i] < 0x10) hexPreview += "0";
+            hexPreview += String(codeBuf[i], HEX) + " "; 
+        }
+    } else {
+        hexPreview = "LOCKED";
+    }
+    hexPreview.toUpperCase();
+
+    String json = "{"; 
+    json+="\"model\":\""+modelName+"\","; 
+    json+="\"rev\":\"0x"+String(chip_rev, HEX)+"\","; 
+    json+="\"mac\":\""+macStr+"\","; 
+    json+="\"flash\":\""+flashSize+"\","; 
+    json+="\"locked\":" + String(isLocked ? "true" : "false") + ","; 
+    json+="\"preview\":\""+hexPreview+"\",";
+    json+="\"raw\":\""+rawDump+"\""; 
+    json+="}";
+    
+    chipInfoCache = json;
+    return json;
+}
+
+// Optional start/length of the job endpoints, decimal or 0x-hex (missing = 0)
+uint32_t rangeParam(AsyncWebServerRequest *r, const char* name) {
+    return r->hasParam(name) ? strtoul(r->getParam(name)->value().c_str(), NULL, 0) : 0;
+}
+
+// "preserve" list of flash and verify: count, 0 = none, -1 = invalid
+int preserveParam(AsyncWebServerRequest *r, PreserveRegion* keep) {
+    if(!r->hasParam("preserve")) return 0;
+    return parsePreserveList(r->getParam("preserve")->value().c_str(), keep, MAX_PRESERVE_REGIONS);
+}
+
 void setup() {
     Serial.begin(115200);
     
@@ -32,9 +289,13 @@ void setup() {
     initFlasherController();
 
     if(!LittleFS.begin(true)){ Serial.println("FS Fail"); return; }
+    initImageStore();
+    Serial.printf("Image store: %s\n", imageInPsram() ? "PSRAM" : "LittleFS");
 
     uint16_t id = cc.begin(PIN_CC_CLK, PIN_CC_DATA, PIN_CC_RST);
+    cc.set_reset_hook(bpRestore); // Every reset into debug mode clears the comparators
     Serial.printf("CC-ID: 0x%04X\n", id);
+    initHaltWatch(); // Idle until a debugger socket connects
 
     // --- WIFI LOGIC ---
     preferences.begin("wifi-config", false); // Open Namespace
@@ -72,27 +333,24 @@ void setup() {
 
     // --- WEB ROUTES ---
 
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request){ request->send(200, "text/html", index_html); });
+    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request){ sendAsset(request, ASSET_INDEX_HTML); });
 
-    server.on("/script.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(200, "application/javascript", javaScript);
-    });
+    server.on("/script.js", HTTP_GET, [](AsyncWebServerRequest *request){ sendAsset(request, ASSET_SCRIPT_JS); });
 
     server.on("/api/system_ip", HTTP_GET, [](AsyncWebServerRequest *r){
         r->send(200, "text/plain", (WiFi.status() == WL_CONNECTED) ? WiFi.localIP().toString() : WiFi.softAPIP().toString());
     });
 
     // API: System Info & Mode
-    server.on("/api/system_info", HTTP_GET, [](AsyncWebServerRequest *r){
-        String json = "{";
-        json += "\"ip\":\"" + (isApMode ? WiFi.softAPIP().toString() : WiFi.localIP().toString()) + "\",";
-        json += "\"mode\":\"" + String(isApMode ? "AP" : "STA") + "\""; 
-        json += "}";
-        r->send(200, "application/json", json);
-    });
+    server.on("/api/system_info", HTTP_GET, [](AsyncWebServerRequest *r){ r->send(200, "application/json", systemInfoJSON()); });
 
+    // Translations of one language: /api/lang/<code> (also routed here by prefix)
     server.on("/api/lang", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(200, "application/json", languages_json);
+        String code = request->url().substring(10);
+        for(uint8_t i = 0; i < LANG_COUNT; i++) {
+            if(code == LANG_CODES[i]) { sendAsset(request, LANG_ASSETS[i]); return; }
+        }
+        request->send(404, "text/plain", "Unknown language");
     });
 
     // API: Save WiFi credentials
@@ -113,106 +371,224 @@ void setup() {
     });
 
     server.on("/api/init", HTTP_GET, [](AsyncWebServerRequest *request){
+        LinkGuard link;
+        if(!link.held) { request->send(200, "text/plain", "BUSY"); return; }
         cc.enable_cc_debug(); cc.clock_init();
         request->send(200, "text/plain", "Init OK");
     });
 
-    server.on("/api/pins", HTTP_GET, [](AsyncWebServerRequest *r){
-        String json = "{";
-        json += "\"clk\":" + String(PIN_CC_CLK) + ",";
-        json += "\"data\":" + String(PIN_CC_DATA) + ",";
-        json += "\"rst\":" + String(PIN_CC_RST);
-        json += "}";
-        r->send(200, "application/json", json);
-    });
+    server.on("/api/pins", HTTP_GET, [](AsyncWebServerRequest *r){ r->send(200, "application/json", pinsJSON()); });
 
     // Info Block
     server.on("/api/info", HTTP_GET, [](AsyncWebServerRequest *request){
-        uint16_t raw_id = cc.send_cc_cmd(0x68);
-        uint8_t chip_id = (raw_id >> 8) & 0xFF; 
-        uint8_t chip_rev = raw_id & 0xFF;
-        
-        String modelName = "Unknown (0x" + String(chip_id, HEX) + ")";
-        String flashSize = "Unknown"; 
-        bool hasMac = true; 
-        bool isLocked = false;
-        
-        String rawDump = ""; 
-        uint8_t infoBuf[8]; 
-        bool allZeros = true;
-        
-        cc.WR_CONFIG(0x01); 
-        cc.read_xdata_memory(0x0000, 8, infoBuf); 
-        cc.WR_CONFIG(0x00); 
-        
-        for(int i=0; i<8; i++){ 
-            if(infoBuf[i] != 0x00) allZeros = false; 
-            if(infoBuf[i]<0x10) rawDump+="0"; 
-            rawDump+=String(infoBuf[i], HEX)+" "; 
-        }
-        rawDump.toUpperCase();
+        LinkGuard link;
+        if(!link.held) { request->send(200, "text/plain", "BUSY"); return; }
+        request->send(200, "application/json", chipInfoJSON());
+    });
 
-        if((chip_id == 0x11 || chip_id == 0x01) && allZeros) {
-            isLocked = true;
-            flashSize = "Locked (Protected)";
-            modelName += " [LOCKED]";
-        }
+    // Everything the page needs at start in one response (pins, system info, chip info).
+    // The link is not touched: the chip info is the one read last, a page load does not
+    // reset the target. Without one the page reads it through /api/init and /api/info.
+    server.on("/api/bootstrap", HTTP_GET, [](AsyncWebServerRequest *r){
+        bool busy = isSystemBusy();
+        String chip = chipInfoCache.length() ? chipInfoCache : String("null");
+        String json = "{\"pins\":" + pinsJSON() + ",\"system\":" + systemInfoJSON() + ",\"chip\":" + chip;
+        json += ",\"busy\":" + String(busy ? "true" : "false") + "}";
+        r->send(200, "application/json", json);
+    });
 
-        if(chip_id == 0x01 || chip_id == 0x11) {
-            modelName = (chip_id == 0x11) ? "CC1111 (USB)" : "CC1110"; hasMac = false;
-            if(!isLocked) flashSize = String(cc.detect_flash_size() / 1024) + " KB (Detected)";
-        } else if(chip_id == 0xA5) { modelName = "CC2530"; hasMac = true; } 
-          else if(chip_id == 0xB5) { modelName = "CC2531"; hasMac = true; }
-
-        String macStr = "N/A (CC111x)";
-        if(hasMac && !isLocked) {
-            uint8_t mac[8]; cc.read_xdata_memory(0x7FF8, 8, mac);
-            macStr = ""; for(int i=0; i<8; i++) { if(mac[i]<0x10) macStr+="0"; macStr+=String(mac[i], HEX); if(i<7) macStr+=":"; }
-            macStr.toUpperCase();
+    server.on("/api/status", HTTP_GET, [](AsyncWebServerRequest *r){
+        char json[STATUS_JSON_SIZE];
+        formatStatusJSON(json, sizeof(json));
+        r->send(200, "application/json", json);
+    });
+
+    // Push channel: the browser subscribes once instead of polling /api/status
+    events.onConnect([](AsyncEventSourceClient *client){
+        char json[STATUS_JSON_SIZE];
+        formatStatusJSON(json, sizeof(json));
+        client->send(json, "status", millis(), 1000);
+    });
+    server.addHandler(&events);
+
+    // Prometheus scrape target: link/job counters plus system gauges
+    server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest *r){
+        AsyncResponseStream *res = r->beginResponseStream("text/plain; version=0.0.4");
+        renderMetrics(*res);
+
+        res->print("# TYPE esp_heap_free_bytes gauge\n");
+        res->printf("esp_heap_free_bytes %lu\n", (unsigned long)ESP.getFreeHeap());
+        res->print("# TYPE esp_heap_min_free_bytes gauge\n");
+        res->printf("esp_heap_min_free_bytes %lu\n", (unsigned long)ESP.getMinFreeHeap());
+        res->print("# TYPE esp_heap_largest_free_block_bytes gauge\n");
+        res->printf("esp_heap_largest_free_block_bytes %lu\n", (unsigned long)ESP.getMaxAllocHeap());
+
+        // Free stack (high-water mark) of the long-running tasks and a running job
+        res->print("# TYPE esp_task_stack_free_bytes gauge\n");
+        const char* tasks[] = { "loopTask", "async_tcp", "Dump", "Flash", "Verify", "Bench", "HaltWatch", "Profile", "StepTrace", "Watch" };
+        for(const char* name : tasks) {
+            TaskHandle_t h = xTaskGetHandle(name);
+            if(h) res->printf("esp_task_stack_free_bytes{task=\"%s\"} %lu\n", name, (unsigned long)uxTaskGetStackHighWaterMark(h));
         }
 
-        String hexPreview = "";
-        if(!isLocked) {
-            uint8_t codeBuf[64];
-            cc.read_code_memory(0x0000, 64, codeBuf);
-            for(int i=0; i<64; i++) {
-                if(codeBuf[i] < 0x10) hexPreview += "0";
-                hexPreview += String(codeBuf[i], HEX) + " "; 
+        // AsyncTCP keeps its event queue private: the SSE backlog is the visible part of it
+        res->print("# TYPE esp_sse_clients gauge\n");
+        res->printf("esp_sse_clients %u\n", (unsigned)events.count());
+        res->print("# TYPE esp_sse_packets_waiting gauge\n");
+        res->printf("esp_sse_packets_waiting %u\n", (unsigned)events.avgPacketsWaiting());
+        res->print("# TYPE esp_ws_debug_clients gauge\n");
+        res->printf("esp_ws_debug_clients %u\n", (unsigned)debugWs.count());
+        HaltWatchStats watch = haltWatchStats();
+        res->print("# TYPE esp_halt_watch_polls_total counter\n");
+        res->printf("esp_halt_watch_polls_total %lu\n", (unsigned long)watch.polls);
+        res->print("# TYPE esp_halt_watch_events_total counter\n");
+        res->printf("esp_halt_watch_events_total %lu\n", (unsigned long)watch.events);
+        res->print("# TYPE esp_halt_watch_interval_ms gauge\n");
+        res->printf("esp_halt_watch_interval_ms %lu\n", (unsigned long)watch.intervalMs);
+
+        res->print("# TYPE esp_wifi_rssi_dbm gauge\n");
+        res->printf("esp_wifi_rssi_dbm %d\n", isApMode ? 0 : WiFi.RSSI());
+        res->print("# TYPE esp_uptime_seconds counter\n");
+        res->printf("esp_uptime_seconds %lu\n", (unsigned long)(millis() / 1000));
+        r->send(res);
+    });
+
+    // Link trace: ring buffer of the last debug frames, exported as frame log or VCD
+    // (more specific paths first, "/api/trace" would match them as prefix)
+    server.on("/api/trace/log", HTTP_GET, [](AsyncWebServerRequest *r){ sendTrace(r, TRACE_LOG); });
+    server.on("/api/trace/vcd", HTTP_GET, [](AsyncWebServerRequest *r){ sendTrace(r, TRACE_VCD); });
+
+    server.on("/api/trace", HTTP_GET, [](AsyncWebServerRequest *r){
+        if(r->hasParam("enable")) {
+            if(r->getParam("enable")->value() != "1") traceStop();
+            else {
+                long depth = r->hasParam("depth") ? r->getParam("depth")->value().toInt() : TRACE_DEFAULT_DEPTH;
+                if(depth > TRACE_MAX_DEPTH) depth = TRACE_MAX_DEPTH;
+                else if(depth <= 0) depth = TRACE_DEFAULT_DEPTH;
+                // The ring is reallocated: not while anyone uses the link and writes into it
+                LinkGuard link;
+                if(!link.held) { r->send(200, "text/plain", "BUSY"); return; }
+                if(!traceStart(depth)) { r->send(500, "text/plain", "NO MEMORY"); return; }
             }
-        } else {
-            hexPreview = "LOCKED";
         }
-        hexPreview.toUpperCase();
-
-        String json = "{"; 
-        json+="\"model\":\""+modelName+"\","; 
-        json+="\"rev\":\"0x"+String(chip_rev, HEX)+"\","; 
-        json+="\"mac\":\""+macStr+"\","; 
-        json+="\"flash\":\""+flashSize+"\","; 
-        json+="\"locked\":" + String(isLocked ? "true" : "false") + ","; 
-        json+="\"preview\":\""+hexPreview+"\",";
-        json+="\"raw\":\""+rawDump+"\""; 
-        json+="}";
-        
-        request->send(200, "application/json", json);
+        char json[160];
+        formatTraceJSON(json, sizeof(json));
+        r->send(200, "application/json", json);
     });
 
-    server.on("/api/status", HTTP_GET, [](AsyncWebServerRequest *r){
-        r->send(200, "application/json", getStatusJSON());
+    // Benchmark: link + primitive throughput; full=1 also erases and programs the target
+    // (more specific paths first, "/api/bench" would match them as prefix)
+    server.on("/api/bench/start", HTTP_GET, [](AsyncWebServerRequest *r){
+        bool full = r->hasParam("full") && r->getParam("full")->value() == "1";
+        if(startBenchTask(full)) r->send(200, "text/plain", "Bench Start");
+        else r->send(200, "text/plain", "BUSY");
+    });
+
+    server.on("/api/bench/history", HTTP_GET, [](AsyncWebServerRequest *r){
+        if(LittleFS.exists("/bench.log")) r->send(LittleFS, "/bench.log", "application/x-ndjson");
+        else r->send(200, "application/x-ndjson", "");
+    });
+
+    server.on("/api/bench", HTTP_GET, [](AsyncWebServerRequest *r){
+        String report = getBenchReport();
+        String json = "{\"running\":" + String(isBenchRunning() ? "true" : "false");
+        json += ",\"report\":" + (report.length() ? report : String("null")) + "}";
+        r->send(200, "application/json", json);
     });
 
+    // PC sampling profiler: /api/profile/start?hz=1000&ms=10000, report as CSV
+    // (/api/profile/report?by=function&top=50), symbol map upload for by=function
+    // (more specific paths first, "/api/profile" would match them as prefix)
+    server.on("/api/profile/start", HTTP_GET, [](AsyncWebServerRequest *r){
+        uint16_t hz = r->hasParam("hz") ? r->getParam("hz")->value().toInt() : 1000;
+        uint32_t ms = r->hasParam("ms") ? r->getParam("ms")->value().toInt() : 10000;
+        if(startProfileTask(hz, ms)) r->send(200, "text/plain", "Profile Start");
+        else r->send(200, "text/plain", isSystemBusy() ? "BUSY" : "FAIL");
+    });
+
+    server.on("/api/profile/stop", HTTP_GET, [](AsyncWebServerRequest *r){
+        stopProfile();
+        r->send(200, "text/plain", "OK");
+    });
+
+    server.on("/api/profile/report", HTTP_GET, [](AsyncWebServerRequest *r){
+        if(isProfileRunning()) { r->send(200, "text/plain", "BUSY"); return; }
+        bool byFunction = r->hasParam("by") && r->getParam("by")->value() == "function";
+        long top = r->hasParam("top") ? r->getParam("top")->value().toInt() : PROFILE_REPORT_ROWS;
+        if(top < 0 || top > PROFILE_REPORT_MAX) top = PROFILE_REPORT_MAX;
+        AsyncResponseStream *res = r->beginResponseStream("text/csv");
+        printProfileReport(*res, byFunction, top);
+        r->send(res);
+    });
+
+    static File symbolFile;
+    server.on("/api/profile/symbols", HTTP_POST, [](AsyncWebServerRequest *r){
+        r->send(200, "text/plain", LittleFS.exists(PROFILE_SYMBOLS_PATH) ? "OK" : "FAIL");
+    }, [](AsyncWebServerRequest *r, String filename, size_t index, uint8_t *data, size_t len, bool final){
+        if(!index) { if(symbolFile) symbolFile.close(); symbolFile = LittleFS.open(PROFILE_SYMBOLS_PATH, "w"); }
+        if(symbolFile && symbolFile.write(data, len) != len) { symbolFile.close(); LittleFS.remove(PROFILE_SYMBOLS_PATH); }
+        if(final && symbolFile) symbolFile.close();
+    });
+
+    server.on("/api/profile", HTTP_GET, [](AsyncWebServerRequest *r){
+        char json[192];
+        formatProfileJSON(json, sizeof(json));
+        r->send(200, "application/json", json);
+    });
+
+    // Live variable watch: /api/watch/start?vars=x16:F000,i:30&hz=50&ms=60000,
+    // samples stream as "watch" events, the ring buffer as CSV from /api/watch/data
+    server.on("/api/watch/start", HTTP_GET, [](AsyncWebServerRequest *r){
+        String vars = r->hasParam("vars") ? r->getParam("vars")->value() : "";
+        uint16_t hz = r->hasParam("hz") ? r->getParam("hz")->value().toInt() : 50;
+        uint32_t ms = r->hasParam("ms") ? r->getParam("ms")->value().toInt() : 60000;
+        if(startWatchTask(vars.c_str(), hz, ms)) r->send(200, "text/plain", "Watch Start");
+        else r->send(200, "text/plain", isSystemBusy() ? "BUSY" : "FAIL");
+    });
+
+    server.on("/api/watch/stop", HTTP_GET, [](AsyncWebServerRequest *r){
+        stopWatch();
+        r->send(200, "text/plain", "OK");
+    });
+
+    server.on("/api/watch/data", HTTP_GET, [](AsyncWebServerRequest *r){
+        if(isWatchRunning()) { r->send(200, "text/plain", "BUSY"); return; }
+        AsyncResponseStream *res = r->beginResponseStream("text/csv");
+        printWatchCSV(*res);
+        r->send(res);
+    });
+
+    server.on("/api/watch", HTTP_GET, [](AsyncWebServerRequest *r){
+        char json[320];
+        formatWatchJSON(json, sizeof(json));
+        r->send(200, "application/json", json);
+    });
+
+    // A running download streams from the dump slot: no new dump until it ends
     server.on("/api/start_dump", HTTP_GET, [](AsyncWebServerRequest *r){
-        if(startDumpTask()) r->send(200, "text/plain", "Dump Start"); 
+        if(dumpReaderActive()) { r->send(409, "text/plain", "BUSY (download running)"); return; }
+        if(startDumpTask(rangeParam(r, "start"), rangeParam(r, "length"))) r->send(200, "text/plain", "Dump Start"); 
         else r->send(200, "text/plain", "BUSY"); 
     });
     
     server.on("/api/start_flash", HTTP_GET, [](AsyncWebServerRequest *r){
-        if(startFlashTask()) r->send(200, "text/plain", "Flash Start"); 
+        PreserveRegion keep[MAX_PRESERVE_REGIONS];
+        int keepCount = preserveParam(r, keep);
+        if(keepCount < 0) { r->send(400, "text/plain", "BAD PRESERVE LIST"); return; }
+        if(startFlashTask(false, rangeParam(r, "start"), rangeParam(r, "length"), keep, keepCount)) r->send(200, "text/plain", "Flash Start"); 
         else r->send(200, "text/plain", "BUSY");
     });
     
+    server.on("/api/resume_flash", HTTP_GET, [](AsyncWebServerRequest *r){
+        if(startFlashTask(true)) r->send(200, "text/plain", "Flash Resume"); 
+        else r->send(200, "text/plain", isSystemBusy() ? "BUSY" : "NO CHECKPOINT");
+    });
+    
     server.on("/api/start_verify", HTTP_GET, [](AsyncWebServerRequest *r){
-        if(startVerifyTask()) r->send(200, "text/plain", "Verify Start"); 
+        PreserveRegion keep[MAX_PRESERVE_REGIONS];
+        int keepCount = preserveParam(r, keep);
+        if(keepCount < 0) { r->send(400, "text/plain", "BAD PRESERVE LIST"); return; }
+        if(startVerifyTask(rangeParam(r, "start"), rangeParam(r, "length"), keep, keepCount)) r->send(200, "text/plain", "Verify Start"); 
         else r->send(200, "text/plain", "BUSY");
     });
 
@@ -228,47 +604,111 @@ void setup() {
         else r->send(500, "text/plain", "FAIL");
     });
 
+    // The stored dump is gzip on LittleFS, a PSRAM dump is compressed on the fly if the client accepts it.
+    // The browser saves the decoded dump.bin (curl needs --compressed).
     server.on("/download/dump.bin", HTTP_GET, [](AsyncWebServerRequest *r){
-        if(LittleFS.exists("/dump.bin")) r->send(LittleFS, "/dump.bin", "application/octet-stream", true); else r->send(404, "text/plain", "No Dump");
+        bool gzip = !imageInPsram() || (r->hasHeader("Accept-Encoding") && r->header("Accept-Encoding").indexOf("gzip") >= 0);
+        std::shared_ptr<DumpReader> reader = std::make_shared<DumpReader>(gzip);
+        if(!*reader) { r->send(404, "text/plain", "No Dump"); return; }
+        AsyncWebServerResponse *res = r->beginChunkedResponse("application/octet-stream",
+            [reader](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                return reader->read(buffer, maxLen);
+            });
+        if(gzip) res->addHeader("Content-Encoding", "gzip");
+        res->addHeader("Content-Disposition", "attachment; filename=dump.bin");
+        r->send(res);
     });
     
-    server.on("/upload", HTTP_POST, [](AsyncWebServerRequest *r){ r->send(200); }, [](AsyncWebServerRequest *r, String filename, size_t index, uint8_t *data, size_t len, bool final){
-        if(!index){ if(LittleFS.exists("/firmware.bin")) LittleFS.remove("/firmware.bin"); r->_tempFile = LittleFS.open("/firmware.bin", "w"); }
-        if(r->_tempFile) r->_tempFile.write(data, len); if(final && r->_tempFile) r->_tempFile.close();
+    // One upload at a time; the image of a running job is not replaced.
+    // gzip uploads (magic 1F 8B) are inflated on the fly.
+    static ImageFile uploadImage;
+    static GunzipWriter uploadGunzip;
+    static bool uploadGzip = false;
+    static AsyncWebServerRequest* uploadBusy = nullptr; // Request refused because a job runs
+    server.on("/upload", HTTP_POST, [](AsyncWebServerRequest *r){
+        if(r == uploadBusy) { uploadBusy = nullptr; r->send(409, "text/plain", "BUSY"); return; }
+        if(imageExists(IMG_FIRMWARE)) r->send(200); else r->send(400, "text/plain", "Upload rejected");
+    }, [](AsyncWebServerRequest *r, String filename, size_t index, uint8_t *data, size_t len, bool final){
+        if(!index){
+            uploadImage.discard(); uploadGunzip.end(); // Unfinished previous upload
+            uploadBusy = isSystemBusy() ? r : nullptr;
+            if(uploadBusy) return;
+            discardFlashCheckpoint();
+            uploadGzip = len >= 2 && data[0] == 0x1F && data[1] == 0x8B;
+            if(uploadImage.open(IMG_FIRMWARE, "w") && uploadGzip && !uploadGunzip.begin(uploadImage)) uploadImage.discard();
+        }
+        if(uploadImage && !(uploadGzip ? uploadGunzip.write(data, len) : uploadImage.write(data, len) == len)) uploadImage.discard();
+        if(final && uploadImage) {
+            if(uploadGzip && !uploadGunzip.finish()) uploadImage.discard();
+            else uploadImage.close();
+        }
     });
 
     // --- DEBUGGER APIs ---
 
+    // Halt watch: /api/debug/watch?hz=1000 sets the poll rate while the CPU runs
+    server.on("/api/debug/watch", HTTP_GET, [](AsyncWebServerRequest *r){
+        if(r->hasParam("hz")) haltWatchSetHz(r->getParam("hz")->value().toInt());
+        char json[128];
+        formatHaltWatchJSON(json, sizeof(json));
+        r->send(200, "application/json", json);
+    });
+
     // Query Status (Running vs Halted)
     server.on("/api/debug/status", HTTP_GET, [](AsyncWebServerRequest *r){
+        LinkGuard link;
+        if(!link.held) { r->send(200, "text/plain", "BUSY"); return; }
         uint8_t s = cc.get_status_byte();
         
         // FIX: 0xFF usually indicates an "Open Bus" (Chip Reset, cable disconnected, or Watchdog Reboot).
         // Although Bit 5 (0x20) is set in 0xFF, it is not a valid HALT state.
         // We force "halted = false" if s == 0xFF to prevent reading garbage registers.
-        bool halted = (s & 0x20) && (s != 0xFF); 
-
-        String json = "{\"halted\":" + String(halted?"true":"false") + ", \"raw\":\"0x" + String(s, HEX) + "\"}";
+        String json = "{\"halted\":" + String(cpuHalted(s)?"true":"false") + ", \"raw\":\"0x" + String(s, HEX) + "\"}";
         r->send(200, "application/json", json);
     });
 
     server.on("/api/debug/halt", HTTP_GET, [](AsyncWebServerRequest *r){
+        LinkGuard link;
+        if(!link.held) { r->send(200, "text/plain", "BUSY"); return; }
+        runControlDisarm();
         cc.debug_halt();
+        bpNoteStop();
         r->send(200, "text/plain", "HALTED");
+        haltWatchKick(); // Other tabs get the new state pushed
     });
 
     server.on("/api/debug/resume", HTTP_GET, [](AsyncWebServerRequest *r){
+        LinkGuard link;
+        if(!link.held) { r->send(200, "text/plain", "BUSY"); return; }
+        runControlDisarm();
+        bpNoteResume();
         cc.debug_resume();
         r->send(200, "text/plain", "RUNNING");
+        haltWatchKick(); // Other tabs get the new state pushed
     });
 
     server.on("/api/debug/step", HTTP_GET, [](AsyncWebServerRequest *r){
+        LinkGuard link;
+        if(!link.held) { r->send(200, "text/plain", "BUSY"); return; }
+        runControlDisarm();
+        bpNoteStop();
         cc.debug_step();
         r->send(200, "text/plain", "STEPPED");
+        haltWatchKick(); // Other tabs get the new state pushed
+    });
+
+    // Step over / step out / run to: /api/debug/run_to?addr=1234 (PC in the current bank)
+    server.on("/api/debug/step_over", HTTP_GET, [](AsyncWebServerRequest *r){ runControl(r, DBG_OP_STEP_OVER); });
+    server.on("/api/debug/step_out", HTTP_GET, [](AsyncWebServerRequest *r){ runControl(r, DBG_OP_STEP_OUT); });
+    server.on("/api/debug/run_to", HTTP_GET, [](AsyncWebServerRequest *r){
+        if(!r->hasParam("addr")) { r->send(400, "text/plain", "Missing addr"); return; }
+        runControl(r, DBG_OP_RUN_TO, strtol(r->getParam("addr")->value().c_str(), NULL, 16));
     });
 
     // Read RAM/SFR: /api/debug/read?addr=0xF000
     server.on("/api/debug/read", HTTP_GET, [](AsyncWebServerRequest *r){
+        LinkGuard link;
+        if(!link.held) { r->send(200, "text/plain", "BUSY"); return; }
         if(r->hasParam("addr")) {
             String addrStr = r->getParam("addr")->value();
             uint16_t addr = strtol(addrStr.c_str(), NULL, 16);
@@ -288,6 +728,8 @@ void setup() {
 
     // Write RAM/SFR: /api/debug/write?addr=0xF000&val=0xFF
     server.on("/api/debug/write", HTTP_GET, [](AsyncWebServerRequest *r){
+        LinkGuard link;
+        if(!link.held) { r->send(200, "text/plain", "BUSY"); return; }
         if(r->hasParam("addr") && r->hasParam("val")) {
             uint16_t addr = strtol(r->getParam("addr")->value().c_str(), NULL, 16);
             uint8_t val = strtol(r->getParam("val")->value().c_str(), NULL, 16);
@@ -301,84 +743,143 @@ void setup() {
         }
     });
 
-    // DEBUG: Get all registers
+    // DEBUG: Get all registers (same snapshot as the debugger channel; only while halted)
     server.on("/api/debug/registers", HTTP_GET, [](AsyncWebServerRequest *r){
-        // Get PC and Registers
-        uint16_t pc = cc.read_pc();
-        uint8_t r_regs[8];
-        cc.read_r0_r7(r_regs);
-        
-        String json = "{";
-        json += "\"PC\":\"0x" + String(pc, HEX) + "\","; 
-        json += "\"ACC\":\"0x" + String(cc.read_sfr(0xE0), HEX) + "\",";
-        json += "\"B\":\"0x" +   String(cc.read_sfr(0xF0), HEX) + "\",";
-        json += "\"PSW\":\"0x" + String(cc.read_sfr(0xD0), HEX) + "\",";
-        json += "\"SP\":\"0x" +  String(cc.read_sfr(0x81), HEX) + "\",";
-        json += "\"DPL\":\"0x" + String(cc.read_sfr(0x82), HEX) + "\","; 
-        json += "\"DPH\":\"0x" + String(cc.read_sfr(0x83), HEX) + "\",";
-        json += "\"DPTR\":\"0x" + String(cc.read_sfr(0x83), HEX) + String(cc.read_sfr(0x82), HEX) + "\",";
-        json += "\"P0\":\"0x" +  String(cc.read_sfr(0x80), HEX) + "\",";
-        json += "\"P1\":\"0x" +  String(cc.read_sfr(0x90), HEX) + "\",";
-        json += "\"P2\":\"0x" +  String(cc.read_sfr(0xA0), HEX) + "\",";
-
-        // R-Register Array
-        json += "\"R\":[";
-        for(int i=0; i<8; i++) {
-            json += "\"0x" + String(r_regs[i], HEX) + "\"";
-            if(i<7) json += ",";
-        }
-        json += "]";
-        json += "}";
-        
-        r->send(200, "application/json", json);
+        LinkGuard link;
+        if(!link.held) { r->send(200, "text/plain", "BUSY"); return; }
+        uint8_t snap[DBG_SNAPSHOT_SIZE];
+        size_t len = readSnapshot(snap);
+        r->send(200, "application/json", snapshotJSON(snap, len));
     });
     
-    // DEBUG: Read Memory Block (for Hex Editor)
-    // /api/debug/mem?addr=0xF000&len=64
-    server.on("/api/debug/mem", HTTP_GET, [](AsyncWebServerRequest *r){
-        uint16_t addr = 0;
-        uint16_t len = 16;
-        if(r->hasParam("addr")) addr = strtol(r->getParam("addr")->value().c_str(), NULL, 16);
-        if(r->hasParam("len")) len = r->getParam("len")->value().toInt();
-        
-        if(len > 512) len = 512; // Limit
-        
-        uint8_t* buf = (uint8_t*)malloc(len);
-        if (!buf) { r->send(500, "text/plain", "Out of memory"); return; }
-
-        cc.read_xdata_memory(addr, len, buf);
-        
-        String hex = "";
-        for(int i=0; i<len; i++) {
-            if(buf[i]<0x10) hex += "0";
-            hex += String(buf[i], HEX);
+    // DEBUG: Read Memory Block (for Hex Editor), raw bytes
+    // /api/debug/mem.bin?space=xdata|code|idata|sfr&addr=F000&len=4096
+    // Streamed in small pieces straight from the target; the link stays reserved until the response is done.
+    server.on("/api/debug/mem.bin", HTTP_GET, [](AsyncWebServerRequest *r){
+        uint8_t space = MEM_XDATA;
+        if(r->hasParam("space")) {
+            String s = r->getParam("space")->value();
+            if(s == "code") space = MEM_CODE;
+            else if(s == "idata") space = MEM_IDATA;
+            else if(s == "sfr") space = MEM_SFR;
+            else if(s != "xdata") { r->send(400, "text/plain", "Bad space"); return; }
         }
-        free(buf);
-        r->send(200, "text/plain", hex);
+        uint32_t addr = r->hasParam("addr") ? strtoul(r->getParam("addr")->value().c_str(), NULL, 16) : 0;
+        uint32_t len = r->hasParam("len") ? r->getParam("len")->value().toInt() : 256;
+        if(!acquireLink()) { r->send(409, "text/plain", "BUSY"); return; }
+
+        uint32_t first = (space == MEM_SFR) ? 0x80 : 0;
+        uint32_t limit = 0x10000;
+        if(space == MEM_CODE) limit = cc.detect_flash_size();
+        else if(space == MEM_IDATA || space == MEM_SFR) limit = 0x100;
+        if(addr < first) addr = first;
+        if(addr > limit) addr = limit;
+        if(len > limit - addr) len = limit - addr;
+
+        std::shared_ptr<MemReader> reader = std::make_shared<MemReader>(space, addr, len);
+        AsyncWebServerResponse *res = r->beginChunkedResponse("application/octet-stream",
+            [reader](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                return reader->read(buffer, maxLen);
+            });
+        res->addHeader("Cache-Control", "no-store");
+        r->send(res);
     });
     
-    // SET BREAKPOINT: /api/debug/bp?addr=F123
-    // DISABLE: /api/debug/bp?addr=off
+    // Instruction trace of the halted CPU: /api/debug/trace/start?steps=5000&until=1234&hits=1&regs=1
+    // (more specific paths first, "/api/debug/trace" would match them as prefix)
+    server.on("/api/debug/trace/start", HTTP_GET, [](AsyncWebServerRequest *r){
+        uint32_t steps = r->hasParam("steps") ? r->getParam("steps")->value().toInt() : 1000;
+        int32_t until = r->hasParam("until") ? strtol(r->getParam("until")->value().c_str(), NULL, 16) : -1;
+        uint16_t hits = r->hasParam("hits") ? r->getParam("hits")->value().toInt() : 1;
+        bool regs = r->hasParam("regs") && r->getParam("regs")->value() == "1";
+        if(startStepTraceTask(steps, until, hits, regs)) r->send(200, "text/plain", "Trace Start");
+        else r->send(200, "text/plain", isSystemBusy() ? "BUSY" : "FAIL");
+    });
+
+    server.on("/api/debug/trace/stop", HTTP_GET, [](AsyncWebServerRequest *r){
+        stopStepTrace();
+        r->send(200, "text/plain", "OK");
+    });
+
+    // Whole trace in one download (layout: step_trace.h)
+    server.on("/api/debug/trace.bin", HTTP_GET, [](AsyncWebServerRequest *r){
+        if(isStepTraceRunning()) { r->send(409, "text/plain", "BUSY"); return; }
+        std::shared_ptr<StepTraceReader> reader = std::make_shared<StepTraceReader>();
+        if(!reader->size()) { r->send(404, "text/plain", "No trace"); return; }
+        AsyncWebServerResponse *res = r->beginChunkedResponse("application/octet-stream",
+            [reader](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                return reader->read(buffer, maxLen);
+            });
+        res->addHeader("Content-Disposition", "attachment; filename=trace.bin");
+        r->send(res);
+    });
+
+    server.on("/api/debug/trace", HTTP_GET, [](AsyncWebServerRequest *r){
+        char json[192];
+        formatStepTraceJSON(json, sizeof(json));
+        r->send(200, "application/json", json);
+    });
+
+    // Breakpoints (all four comparators, set and cleared without stopping the target):
+    // SET: /api/debug/bp?addr=F123 (PC in the mapped bank), &bank=3 or a flat address (1A123) for another bank
+    // CLEAR: /api/debug/bp?clear=F123, all: /api/debug/bp?addr=off
+    // LIST: /api/debug/bp (from the cache, also during jobs)
     server.on("/api/debug/bp", HTTP_GET, [](AsyncWebServerRequest *r){
-        if(r->hasParam("addr")) {
-            String val = r->getParam("addr")->value();
-            
-            // Halt first to be safe
-            cc.debug_halt(); 
-            
-            if(val == "off" || val == "OFF") {
-                cc.disable_hw_breakpoint();
-                r->send(200, "text/plain", "BP DISABLED");
-            } else {
-                uint16_t addr = strtol(val.c_str(), NULL, 16);
-                cc.set_hw_breakpoint(addr);
-                r->send(200, "text/plain", "BP SET @ " + val);
-            }
+        if(!r->hasParam("addr") && !r->hasParam("clear")) {
+            char json[1024];
+            formatBreakpointsJSON(json, sizeof(json));
+            r->send(200, "application/json", json);
+            return;
+        }
+        LinkGuard link;
+        if(!link.held) { r->send(200, "text/plain", "BUSY"); return; }
+        int16_t bank = r->hasParam("bank") ? r->getParam("bank")->value().toInt() : -1;
+        String val = r->getParam(r->hasParam("clear") ? "clear" : "addr")->value();
+        if(val == "off" || val == "OFF") {
+            bpClearAll();
+            r->send(200, "text/plain", "BP DISABLED");
+            return;
+        }
+        uint32_t addr = strtoul(val.c_str(), NULL, 16);
+        if(addr <= 0xFFFF) addr = codeAddress(addr, bank);
+        if(r->hasParam("clear")) {
+            r->send(200, "text/plain", bpClear(addr) ? "BP CLEARED @ " + val : "NO BP @ " + val);
         } else {
-            r->send(400, "text/plain", "Missing addr");
+            BpCondition cond = {};
+            if(r->hasParam("cond") && !parseBpCondition(r->getParam("cond")->value().c_str(), cond)) {
+                r->send(200, "text/plain", "BAD CONDITION");
+                return;
+            }
+            int8_t n = bpSet(addr, &cond);
+            if(n < 0) r->send(200, "text/plain", addr > BP_MAX_ADDRESS ? "BAD ADDRESS" : "BP FULL");
+            else r->send(200, "text/plain", "BP" + String(n) + " SET @ " + val);
         }
     });
+
+    // Debugger channel: one binary request per message, answered in order.
+    // Requests are a few bytes, fragmented messages are not expected.
+    debugWs.onEvent([](AsyncWebSocket *ws, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len){
+        if(type != WS_EVT_DATA) return;
+        AwsFrameInfo *info = (AwsFrameInfo*)arg;
+        if(!info->final || info->index != 0 || info->len != len || info->opcode != WS_BINARY) return;
+        static uint8_t resp[DBG_RESPONSE_MAX];
+        size_t n = handleDebugRequest(data, len, resp);
+        if(n == 0) return;
+        client->binary(resp, n);
+        // Other tabs follow run state changes through the push channel
+        bool control = resp[0] == DBG_OP_HALT || resp[0] == DBG_OP_RESUME || resp[0] == DBG_OP_STEP ||
+                       resp[0] == DBG_OP_STEP_OVER || resp[0] == DBG_OP_STEP_OUT || resp[0] == DBG_OP_RUN_TO;
+        if(control && resp[2] == DBG_OK) haltWatchKick();
+    });
+    server.addHandler(&debugWs);
+
     server.begin();
 }
 
-void loop() { delay(100); }
\ No newline at end of file
+void loop() {
+    pumpEvents();
+    pumpDebugEvents();
+    pumpWatchEvents();
+    debugWs.cleanupClients();
+    delay(10);
+}
\ No newline at end of file
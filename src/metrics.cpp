@@ -0,0 +1,119 @@
+#include "metrics.h"
+#include "flasher_controller.h"
+
+LinkMetrics linkMetrics = {};
+
+// Bucket bounds: link operations in microseconds, job phases in milliseconds
+static const uint32_t LATENCY_BOUNDS_US[] = { 50, 100, 250, 500, 1000, 2500, 5000, 10000, 50000, 100000, 500000 };
+static const uint32_t PHASE_BOUNDS_MS[]   = { 100, 500, 1000, 2500, 5000, 10000, 30000, 60000, 120000, 300000, 600000 };
+static const uint8_t LATENCY_BUCKETS = sizeof(LATENCY_BOUNDS_US) / sizeof(uint32_t) + 1;
+static const uint8_t PHASE_BUCKETS = sizeof(PHASE_BOUNDS_MS) / sizeof(uint32_t) + 1;
+
+static const char* OP_NAMES[OP_COUNT] = {
+    "opcode", "xdata_read", "xdata_write", "code_read", "erase_chip", "erase_page", "flash_block_write", "idle_wait"
+};
+static const char* PHASE_NAMES[] = {
+    "idle", "init", "detect", "prepare", "erase", "read", "write", "verify", "resume", "lock", "repair", "preserve"
+};
+static const char* JOB_NAMES[] = { "none", "dump", "flash", "verify", "erase", "lock" };
+static const uint8_t PHASE_SLOTS = sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]);
+static const uint8_t JOB_SLOTS = sizeof(JOB_NAMES) / sizeof(JOB_NAMES[0]);
+
+static Histogram opLatency[OP_COUNT];
+static Histogram phaseDuration[PHASE_SLOTS];
+static Histogram jobDuration[JOB_SLOTS];
+static uint32_t jobsOk[JOB_SLOTS];
+static uint32_t jobsFailed[JOB_SLOTS];
+static uint32_t jobStackFree[JOB_SLOTS];  // Lowest free stack seen (bytes), 0 = never ran
+static uint32_t pageRepairs[2];           // Failed, repaired
+
+void Histogram::observe(uint32_t value) {
+    uint8_t i = 0;
+    while(i < buckets - 1 && value > bounds[i]) i++;
+    counts[i]++;
+    count++;
+    sum += value;
+}
+
+void metricsObserveOp(LinkOp op, uint32_t us) {
+    Histogram &h = opLatency[op];
+    if(!h.bounds) { h.bounds = LATENCY_BOUNDS_US; h.buckets = LATENCY_BUCKETS; }
+    h.observe(us);
+}
+
+void metricsObservePhase(uint8_t phase, uint32_t ms) {
+    if(phase == PHASE_IDLE || phase >= PHASE_SLOTS) return;
+    Histogram &h = phaseDuration[phase];
+    if(!h.bounds) { h.bounds = PHASE_BOUNDS_MS; h.buckets = PHASE_BUCKETS; }
+    h.observe(ms);
+}
+
+void metricsJobDone(uint8_t job, bool ok, uint32_t ms, uint32_t stackFree) {
+    if(job >= JOB_SLOTS) return;
+    if(ok) jobsOk[job]++; else jobsFailed[job]++;
+    Histogram &h = jobDuration[job];
+    if(!h.bounds) { h.bounds = PHASE_BOUNDS_MS; h.buckets = PHASE_BUCKETS; }
+    h.observe(ms);
+    if(jobStackFree[job] == 0 || stackFree < jobStackFree[job]) jobStackFree[job] = stackFree;
+}
+
+void metricsPageRepair(bool ok) {
+    pageRepairs[ok ? 1 : 0]++;
+}
+
+static void renderHistogram(Print &out, const char* name, const char* label, const char* value, const Histogram &h, float scale) {
+    if(!h.bounds) return;
+    uint32_t cumulative = 0;
+    for(uint8_t i = 0; i < h.buckets - 1; i++) {
+        cumulative += h.counts[i];
+        out.printf("%s_bucket{%s=\"%s\",le=\"%g\"} %lu\n", name, label, value, h.bounds[i] * scale, (unsigned long)cumulative);
+    }
+    out.printf("%s_bucket{%s=\"%s\",le=\"+Inf\"} %lu\n", name, label, value, (unsigned long)h.count);
+    out.printf("%s_sum{%s=\"%s\"} %g\n", name, label, value, (double)h.sum * scale);
+    out.printf("%s_count{%s=\"%s\"} %lu\n", name, label, value, (unsigned long)h.count);
+}
+
+void renderMetrics(Print &out) {
+    out.print("# HELP cc_debug_frames_total Frames sent on the debug link.\n# TYPE cc_debug_frames_total counter\n");
+    out.printf("cc_debug_frames_total{type=\"command\"} %lu\n", (unsigned long)linkMetrics.cmdFrames);
+    out.printf("cc_debug_frames_total{type=\"instr\"} %lu\n", (unsigned long)linkMetrics.instrFrames);
+
+    out.print("# HELP cc_link_bytes_total Bytes clocked on the debug link.\n# TYPE cc_link_bytes_total counter\n");
+    out.printf("cc_link_bytes_total{dir=\"tx\"} %lu\n", (unsigned long)linkMetrics.bytesTx);
+    out.printf("cc_link_bytes_total{dir=\"rx\"} %lu\n", (unsigned long)linkMetrics.bytesRx);
+
+    out.print("# HELP cc_link_retries_total Link operations repeated after an error.\n# TYPE cc_link_retries_total counter\n");
+    out.printf("cc_link_retries_total %lu\n", (unsigned long)linkMetrics.retries);
+    out.print("# HELP cc_link_timeouts_total Link operations that timed out.\n# TYPE cc_link_timeouts_total counter\n");
+    out.printf("cc_link_timeouts_total %lu\n", (unsigned long)linkMetrics.timeouts);
+
+    out.print("# HELP cc_flash_page_repairs_total Page erase/reprogram attempts after a verify mismatch.\n# TYPE cc_flash_page_repairs_total counter\n");
+    out.printf("cc_flash_page_repairs_total{result=\"ok\"} %lu\n", (unsigned long)pageRepairs[1]);
+    out.printf("cc_flash_page_repairs_total{result=\"failed\"} %lu\n", (unsigned long)pageRepairs[0]);
+
+    out.print("# HELP cc_op_latency_seconds Latency of debug link operations.\n# TYPE cc_op_latency_seconds histogram\n");
+    for(uint8_t op = 0; op < OP_COUNT; op++) {
+        renderHistogram(out, "cc_op_latency_seconds", "op", OP_NAMES[op], opLatency[op], 1e-6f);
+    }
+
+    out.print("# HELP cc_job_phase_seconds Duration of job phases.\n# TYPE cc_job_phase_seconds histogram\n");
+    for(uint8_t ph = 0; ph < PHASE_SLOTS; ph++) {
+        renderHistogram(out, "cc_job_phase_seconds", "phase", PHASE_NAMES[ph], phaseDuration[ph], 1e-3f);
+    }
+
+    out.print("# HELP cc_job_duration_seconds Duration of finished jobs.\n# TYPE cc_job_duration_seconds histogram\n");
+    for(uint8_t j = 1; j < JOB_SLOTS; j++) {
+        renderHistogram(out, "cc_job_duration_seconds", "job", JOB_NAMES[j], jobDuration[j], 1e-3f);
+    }
+
+    out.print("# HELP cc_jobs_total Finished jobs.\n# TYPE cc_jobs_total counter\n");
+    for(uint8_t j = 1; j < JOB_SLOTS; j++) {
+        out.printf("cc_jobs_total{job=\"%s\",result=\"ok\"} %lu\n", JOB_NAMES[j], (unsigned long)jobsOk[j]);
+        out.printf("cc_jobs_total{job=\"%s\",result=\"error\"} %lu\n", JOB_NAMES[j], (unsigned long)jobsFailed[j]);
+    }
+
+    out.print("# HELP cc_job_stack_free_min_bytes Lowest free stack of a job task.\n# TYPE cc_job_stack_free_min_bytes gauge\n");
+    for(uint8_t j = 1; j < JOB_SLOTS; j++) {
+        if(jobStackFree[j]) out.printf("cc_job_stack_free_min_bytes{job=\"%s\"} %lu\n", JOB_NAMES[j], (unsigned long)jobStackFree[j]);
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <Arduino.h>
+
+// --- PERFORMANCE COUNTERS ---
+// Exported in Prometheus text format on /metrics.
+// Written by the task that currently owns the debug link (one at a time),
+// read by the web server. Counters are plain 32-bit words: a scrape may be
+// a few microseconds stale, but never sees a torn value.
+
+enum LinkOp : uint8_t {
+    OP_OPCODE,        // One DEBUG_INSTR frame
+    OP_XDATA_READ,
+    OP_XDATA_WRITE,
+    OP_CODE_READ,
+    OP_ERASE_CHIP,
+    OP_ERASE_PAGE,
+    OP_FLASH_BLOCK,   // One flash loader run (up to 64 bytes)
+    OP_IDLE_WAIT,     // Polling GET_STATUS until the CPU is idle
+    OP_COUNT
+};
+
+struct Histogram {
+    static const uint8_t MAX_BUCKETS = 12;
+    const uint32_t* bounds;         // Upper bucket bounds (ascending), last bucket = +Inf
+    uint8_t buckets;
+    uint32_t counts[MAX_BUCKETS];   // Per bucket (not cumulative)
+    uint32_t count;
+    uint64_t sum;
+
+    void observe(uint32_t value);
+};
+
+struct LinkMetrics {
+    uint32_t cmdFrames;     // Debug commands (GET_STATUS, CHIP_ERASE, WR_CONFIG, ...)
+    uint32_t instrFrames;   // DEBUG_INSTR frames (opcode())
+    uint32_t bytesTx;       // Bytes clocked out on DD
+    uint32_t bytesRx;       // Bytes clocked in from DD
+    uint32_t retries;
+    uint32_t timeouts;
+};
+
+extern LinkMetrics linkMetrics;
+
+void metricsObserveOp(LinkOp op, uint32_t us);
+void metricsObservePhase(uint8_t phase, uint32_t ms);
+void metricsJobDone(uint8_t job, bool ok, uint32_t ms, uint32_t stackFree);
+void metricsPageRepair(bool ok);
+
+// Writes all counters and histograms (system gauges are added by the caller)
+void renderMetrics(Print &out);
+
+// Measures the lifetime of the enclosing scope
+class OpTimer {
+    LinkOp _op;
+    uint32_t _start;
+public:
+    OpTimer(LinkOp op) : _op(op), _start(micros()) {}
+    ~OpTimer() { metricsObserveOp(_op, micros() - _start); }
+};
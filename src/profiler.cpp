@@ -0,0 +1,283 @@
+#include "profiler.h"
+#include "cc_interface.h"
+#include "flasher_controller.h"
+#include "debug_channel.h"
+#include <LittleFS.h>
+#include <algorithm>
+
+// --- CONFIGURATION ---
+const char* PROFILE_SYMBOLS_PATH = "/profile.sym";
+const uint8_t SFR_MEMCTR = 0xC7;                  // Code bank of 0x8000-0xFFFF (see map_code_bank)
+const uint32_t SLOT_EMPTY = 0xFFFFFFFF;
+const uint16_t SLOT_LIMIT = PROFILE_SLOTS * 3 / 4; // Keeps the linear probing short
+const uint32_t PROFILE_YIELD_MS = 100;            // Busy-wait sampling still lets the idle task run
+
+struct ProfileSlot {
+    uint32_t addr;
+    uint32_t count;
+};
+
+enum ProfileEnd : uint8_t { PROF_RUNNING, PROF_DONE, PROF_STOPPED, PROF_HALTED, PROF_NO_TARGET };
+static const char* END_NAMES[] = { "running", "done", "stopped", "target halted", "no target" };
+
+static ProfileSlot* slots = nullptr;
+static volatile bool running = false;
+static volatile bool stopRequested = false;
+static uint16_t profileHz = 0;
+static uint32_t profileMs = 0;
+static bool profileBanked = false;
+static bool slotsSorted = false;                  // Compacted and sorted by count (report)
+static volatile uint32_t samples = 0, dropped = 0, used = 0, elapsedMs = 0;
+static volatile uint8_t endReason = PROF_DONE;
+
+static void record(uint32_t addr) {
+    uint32_t i = ((addr * 2654435761u) >> 16) & (PROFILE_SLOTS - 1);
+    for(;;) {
+        ProfileSlot &s = slots[i];
+        if(s.addr == addr) { s.count++; return; }
+        if(s.addr == SLOT_EMPTY) break;
+        i = (i + 1) & (PROFILE_SLOTS - 1);
+    }
+    if(used >= SLOT_LIMIT) { dropped++; return; }
+    slots[i].addr = addr;
+    slots[i].count = 1;
+    used++;
+}
+
+void task_Profile(void * parameter) {
+    profileBanked = cc.is_cc253x();
+    uint32_t period = 1000000UL / profileHz;
+    uint32_t start = millis(), lastYield = start;
+    uint32_t next = micros();
+    uint8_t reason = PROF_DONE;
+
+    while(millis() - start < profileMs) {
+        if(stopRequested) { reason = PROF_STOPPED; break; }
+        uint8_t status = cc.get_status_byte();
+        if(status == 0xFF) { reason = PROF_NO_TARGET; break; }
+        if(cpuHalted(status)) { reason = PROF_HALTED; break; } // Not stopped by us: leave it there
+
+        cc.debug_break();
+        uint16_t pc = cc.read_pc();
+        uint8_t bank = 0;
+        if(profileBanked && pc >= 0x8000) {
+            cc.read_sfrs(&SFR_MEMCTR, 1, &bank);
+            bank &= 0x07;
+        }
+        cc.debug_continue();
+        record((profileBanked && pc >= 0x8000) ? (uint32_t)bank * 0x8000 + (pc - 0x8000) : pc);
+        samples++;
+
+        next += period;
+        int32_t wait = (int32_t)(next - micros());
+        if(wait >= 1000) { vTaskDelay(wait / 1000); lastYield = millis(); }
+        else if(wait > 0) delayMicroseconds(wait);
+        else if(wait < -(int32_t)period) next = micros(); // Link slower than the rate: no catch-up burst
+        if(millis() - lastYield >= PROFILE_YIELD_MS) { vTaskDelay(1); lastYield = millis(); }
+    }
+
+    elapsedMs = millis() - start;
+    endReason = reason;
+    running = false;
+    releaseLink();
+    vTaskDelete(NULL);
+}
+
+bool startProfileTask(uint16_t hz, uint32_t durationMs) {
+    if(hz == 0 || hz > PROFILE_MAX_HZ || durationMs == 0 || durationMs > PROFILE_MAX_MS) return false;
+    if(!acquireLink()) return false;
+    if(!slots) slots = (ProfileSlot*)(psramFound() ? ps_malloc(PROFILE_SLOTS * sizeof(ProfileSlot))
+                                                   : malloc(PROFILE_SLOTS * sizeof(ProfileSlot)));
+    if(!slots) { releaseLink(); return false; }
+    for(uint16_t i = 0; i < PROFILE_SLOTS; i++) slots[i] = { SLOT_EMPTY, 0 };
+    samples = dropped = used = elapsedMs = 0;
+    profileHz = hz;
+    profileMs = durationMs;
+    slotsSorted = false;
+    stopRequested = false;
+    endReason = PROF_RUNNING;
+    running = true;
+    xTaskCreate(task_Profile, "Profile", 4096, NULL, 1, NULL);
+    return true;
+}
+
+bool isProfileRunning() {
+    return running;
+}
+
+void stopProfile() {
+    if(running) stopRequested = true;
+}
+
+size_t formatProfileJSON(char* buf, size_t len) {
+    return snprintf(buf, len, "{\"running\":%s,\"state\":\"%s\",\"hz\":%u,\"ms\":%lu,\"elapsed_ms\":%lu,"
+                    "\"samples\":%lu,\"addresses\":%lu,\"dropped\":%lu}",
+                    running ? "true" : "false", END_NAMES[endReason], (unsigned)profileHz,
+                    (unsigned long)profileMs, (unsigned long)(running ? 0 : elapsedMs),
+                    (unsigned long)samples, (unsigned long)used, (unsigned long)dropped);
+}
+
+// Used slots to the front, most samples first (the hash lookup is not needed after the run)
+static void sortSlots() {
+    if(slotsSorted) return;
+    uint16_t n = 0;
+    for(uint16_t i = 0; i < PROFILE_SLOTS; i++) if(slots[i].addr != SLOT_EMPTY) slots[n++] = slots[i];
+    std::sort(slots, slots + n, [](const ProfileSlot &a, const ProfileSlot &b) { return a.count > b.count; });
+    slotsSorted = true;
+}
+
+static float percent(uint32_t count) {
+    return samples ? 100.0f * count / samples : 0;
+}
+
+// --- SYMBOL MAP ---
+// Only address, line offset and the summed samples are kept per symbol;
+// names are read back from the file for the printed rows.
+
+struct Symbol {
+    uint32_t addr;
+    uint32_t offset;  // Line start in the map file
+    uint32_t count;
+};
+
+static bool isHexToken(const char* t, size_t len) {
+    if(len > 2 && t[0] == '0' && (t[1] == 'x' || t[1] == 'X')) { t += 2; len -= 2; }
+    if(len < 4 || len > 8) return false;
+    for(size_t i = 0; i < len; i++) if(!isxdigit((unsigned char)t[i])) return false;
+    return true;
+}
+
+static bool isNameToken(const char* t, size_t len) {
+    return len > 1 && (isalpha((unsigned char)t[0]) || strchr("_.$?", t[0])) && t[len - 1] != ':';
+}
+
+// "C: 00000062 _main module" (SDCC), "00000062 T main" (nm), "main 0x0062 ..." (others).
+// Data symbols (other SDCC areas, nm types d/b/r) are skipped. Returns false = no code symbol.
+static bool parseSymbolLine(const char* line, uint32_t &addr, char* name = nullptr, size_t nameSize = 0) {
+    const char* tok[12];
+    size_t tokLen[12];
+    uint8_t n = 0;
+    for(const char* p = line; *p && n < 12; ) {
+        while(*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+        if(!*p) break;
+        tok[n] = p;
+        while(*p && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') p++;
+        tokLen[n] = p - tok[n];
+        n++;
+    }
+    int addrTok = -1;
+    for(uint8_t i = 0; i < n; i++) {
+        if(tokLen[i] == 2 && tok[i][1] == ':' && toupper(tok[i][0]) != 'C') return false; // SDCC data area
+        if(tokLen[i] == 1 && strchr("dDbBrR", tok[i][0])) return false;                    // nm data symbol
+        if(addrTok < 0 && isHexToken(tok[i], tokLen[i])) addrTok = i;
+    }
+    if(addrTok < 0) return false;
+    int nameTok = -1;
+    for(int i = addrTok + 1; i < n && nameTok < 0; i++) if(isNameToken(tok[i], tokLen[i])) nameTok = i;
+    for(int i = 0; i < addrTok && nameTok < 0; i++) if(isNameToken(tok[i], tokLen[i])) nameTok = i;
+    if(nameTok < 0) return false;
+    addr = strtoul(tok[addrTok], NULL, 16);
+    if(name) {
+        size_t len = (tokLen[nameTok] < nameSize - 1) ? tokLen[nameTok] : nameSize - 1;
+        memcpy(name, tok[nameTok], len);
+        name[len] = 0;
+    }
+    return true;
+}
+
+// Reads one line (truncated to the buffer), returns false at the end of the file
+static bool readLine(File &f, char* buf, size_t size) {
+    size_t len = 0;
+    int c;
+    while((c = f.read()) >= 0 && c != '\n') if(len < size - 1) buf[len++] = c;
+    buf[len] = 0;
+    return c >= 0 || len > 0;
+}
+
+// Banked linkers (SDCC, IAR) put bank n at n*0x10000+0x8000..0xFFFF. Such a map
+// has addresses above 64 KB only in the upper half; a flat map has them everywhere.
+static bool bankedLayout(const Symbol* syms, uint32_t count) {
+    bool high = false;
+    for(uint32_t i = 0; i < count; i++) {
+        if(syms[i].addr < 0x10000) continue;
+        if((syms[i].addr & 0xFFFF) < 0x8000) return false;
+        high = true;
+    }
+    return high;
+}
+
+// 0x18000 (bank 1) -> 0x08000, 0x28000 (bank 2) -> 0x10000, like the samples
+static uint32_t flatAddress(uint32_t addr) {
+    return (addr < 0x10000) ? addr : (addr >> 16) * 0x8000 + (addr & 0x7FFF);
+}
+
+static void printByFunction(Print &out, uint16_t top) {
+    File f = LittleFS.open(PROFILE_SYMBOLS_PATH, "r");
+    if(!f) { out.print("# no symbol map (upload to /api/profile/symbols)\n"); return; }
+
+    uint32_t capacity = psramFound() ? 16384 : 4096;
+    Symbol* syms = (Symbol*)(psramFound() ? ps_malloc(capacity * sizeof(Symbol)) : malloc(capacity * sizeof(Symbol)));
+    if(!syms) { f.close(); out.print("# out of memory\n"); return; }
+
+    uint32_t count = 0, ignored = 0;
+    char line[160];
+    uint32_t offset = f.position();
+    while(readLine(f, line, sizeof(line))) {
+        uint32_t addr;
+        if(parseSymbolLine(line, addr)) {
+            if(count < capacity) syms[count++] = { addr, offset, 0 };
+            else ignored++;
+        }
+        offset = f.position();
+    }
+    bool banked = bankedLayout(syms, count);
+    if(banked) for(uint32_t i = 0; i < count; i++) syms[i].addr = flatAddress(syms[i].addr);
+    std::sort(syms, syms + count, [](const Symbol &a, const Symbol &b) { return a.addr < b.addr; });
+
+    // Each sample belongs to the closest symbol at or below its address
+    uint32_t unknown = 0;
+    for(uint32_t i = 0; i < used; i++) {
+        Symbol* s = std::upper_bound(syms, syms + count, slots[i].addr,
+                                     [](uint32_t a, const Symbol &sym) { return a < sym.addr; });
+        if(s == syms) unknown += slots[i].count;
+        else (s - 1)->count += slots[i].count;
+    }
+    std::sort(syms, syms + count, [](const Symbol &a, const Symbol &b) { return a.count > b.count; });
+
+    out.printf("# %lu symbols", (unsigned long)count);
+    if(banked) out.print(", banked addresses (n*0x10000+pc)");
+    if(ignored) out.printf(", %lu ignored (limit)", (unsigned long)ignored);
+    out.print("\nsymbol,start,samples,percent\n");
+    for(uint32_t i = 0; i < count && syms[i].count && i < top; i++) {
+        char name[64];
+        uint32_t addr;
+        f.seek(syms[i].offset);
+        readLine(f, line, sizeof(line));
+        parseSymbolLine(line, addr, name, sizeof(name));
+        out.printf("%s,0x%05lX,%lu,%.2f\n", name, (unsigned long)syms[i].addr,
+                   (unsigned long)syms[i].count, percent(syms[i].count));
+    }
+    if(unknown) out.printf("(unknown),,%lu,%.2f\n", (unsigned long)unknown, percent(unknown));
+    free(syms);
+    f.close();
+}
+
+void printProfileReport(Print &out, bool byFunction, uint16_t top) {
+    if(!slots || running) return;
+    if(top == 0 || top > PROFILE_REPORT_MAX) top = PROFILE_REPORT_MAX;
+    sortSlots();
+    out.printf("# %lu samples at %u Hz, %lu ms, %s", (unsigned long)samples, (unsigned)profileHz,
+               (unsigned long)elapsedMs, END_NAMES[endReason]);
+    if(dropped) out.printf(", %lu dropped (table full)", (unsigned long)dropped);
+    out.print("\n");
+    if(byFunction) { printByFunction(out, top); return; }
+
+    out.print("flat,bank,pc,samples,percent\n");
+    for(uint32_t i = 0; i < used && i < top; i++) {
+        uint32_t addr = slots[i].addr;
+        uint8_t bank = profileBanked ? addr / 0x8000 : 0;
+        uint16_t pc = (profileBanked && bank) ? 0x8000 + (addr & 0x7FFF) : addr;
+        out.printf("0x%05lX,%u,0x%04X,%lu,%.2f\n", (unsigned long)addr, bank, pc,
+                   (unsigned long)slots[i].count, percent(slots[i].count));
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <Arduino.h>
+
+// --- PC SAMPLING PROFILER ---
+// Statistical profile of the running target firmware without any
+// instrumentation. At a fixed rate the job stops the CPU in place
+// (CMD_HALT), reads the PC (GET_PC, plus the code bank above 0x8000 on
+// CC253x) and lets it continue. Samples are counted per flat flash address
+// (bank * 32 KB + offset) in a hash table in ESP memory, PSRAM if present.
+// Each sample stops the CPU for about 6 debug frames (~0.3 ms at the
+// default link speed): the rate trades resolution against perturbation.
+// A CPU that halts by itself (breakpoint) ends the profile.
+
+const uint16_t PROFILE_MAX_HZ = 2000;
+const uint32_t PROFILE_MAX_MS = 600000;
+const uint16_t PROFILE_SLOTS = 4096;          // Distinct addresses (power of 2)
+const uint16_t PROFILE_REPORT_ROWS = 100;     // Default rows of the report
+const uint16_t PROFILE_REPORT_MAX = 512;      // The report is built in RAM before it is sent
+extern const char* PROFILE_SYMBOLS_PATH;      // Symbol map for the per-function report
+
+// Returns: false = system busy, bad parameters or out of memory
+bool startProfileTask(uint16_t hz, uint32_t durationMs);
+bool isProfileRunning();
+void stopProfile();                           // Ends a running profile early
+
+size_t formatProfileJSON(char* buf, size_t len);
+
+// Hot table (CSV) sorted by samples. byFunction: samples summed per symbol
+// of PROFILE_SYMBOLS_PATH, one "address name" pair per line (hex address,
+// flat like the profile or banked as n*0x10000+pc; SDCC .map and nm output
+// work). top = 0 or above PROFILE_REPORT_MAX: PROFILE_REPORT_MAX rows.
+void printProfileReport(Print &out, bool byFunction, uint16_t top);
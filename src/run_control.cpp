@@ -0,0 +1,85 @@
+#include "run_control.h"
+#include "cc_interface.h"
+#include "debug_channel.h"
+#include "insn8051.h"
+#include "breakpoints.h"
+
+// --- CONFIGURATION ---
+const uint8_t SFR_SP = 0x81;
+const uint8_t STACK_SCAN = 16;         // Bytes above SP searched for the return address
+
+static int8_t armed = -1;               // Comparator of the temporary breakpoint
+
+static uint8_t readSP() {
+    uint8_t sp;
+    cc.read_sfrs(&SFR_SP, 1, &sp);
+    return sp;
+}
+
+void runControlDisarm() {
+    if(armed < 0) return;
+    bpDisarmTemp(armed);
+    armed = -1;
+}
+
+// Resumes until the CPU halts. A halt on target with SP above spLimit
+// (spLimit >= 0) is a deeper call level of the same code: resume again.
+static RunResult resumeTo(uint16_t target, int16_t spLimit) {
+    armed = bpArmTemp(codeAddress(target));
+    if(armed < 0) return RUN_NO_BREAKPOINT;
+    uint32_t start = millis();
+    bpNoteResume();
+    cc.debug_continue();
+    while(millis() - start < RUN_WAIT_MS) {
+        uint8_t status = cc.get_status_byte();
+        if(status == 0xFF) return RUN_RUNNING; // Target gone: the halt watch reports it
+        if(!cpuHalted(status)) { vTaskDelay(1); continue; }
+        if(bpFilterHit()) continue; // Conditional breakpoint on the way, condition false
+        if(spLimit >= 0 && cc.read_pc() == target && readSP() > spLimit) { cc.debug_continue(); continue; }
+        runControlDisarm();
+        bpNoteStop();
+        return RUN_HALTED;
+    }
+    return RUN_RUNNING;
+}
+
+RunResult stepOver() {
+    runControlDisarm();
+    uint16_t pc = cc.read_pc();
+    uint8_t op;
+    cc.read_code_mapped(pc, 1, &op);
+    if(insnTableFlow(op) != FLOW_CALL) {
+        bpNoteStop();
+        cc.debug_step();
+        return RUN_HALTED;
+    }
+    return resumeTo(pc + insnTableLength(op), readSP());
+}
+
+// Address directly behind an LCALL or ACALL?
+static bool followsCall(uint16_t addr) {
+    if(addr < 2) return false;
+    uint8_t code[3];
+    if(addr < 3) { code[0] = 0; cc.read_code_mapped(addr - 2, 2, code + 1); }
+    else cc.read_code_mapped(addr - 3, 3, code);
+    return code[0] == 0x12 || (code[1] & 0x1F) == 0x11;
+}
+
+RunResult stepOut() {
+    runControlDisarm();
+    uint8_t sp = readSP();
+    uint8_t low = (sp >= STACK_SCAN - 1) ? sp - (STACK_SCAN - 1) : 0;
+    uint8_t stack[STACK_SCAN];
+    cc.read_idata_memory(low, sp - low + 1, stack);
+    // CALL pushes PC low, then high: high byte at the top, popped by RET
+    for(int16_t hi = sp; hi > low; hi--) {
+        uint16_t ret = (stack[hi - low] << 8) | stack[hi - 1 - low];
+        if(followsCall(ret)) return resumeTo(ret, hi - 2);
+    }
+    return RUN_NO_RETURN;
+}
+
+RunResult runTo(uint16_t address) {
+    runControlDisarm();
+    return resumeTo(address, -1);
+}
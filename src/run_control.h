@@ -0,0 +1,26 @@
+#pragma once
+#include <Arduino.h>
+
+// --- RUN CONTROL ---
+// Step over, step out and run to an address with one resume instead of
+// thousands of single steps. The instruction at the PC is decoded on the
+// ESP (insn8051.h); a temporary hardware breakpoint on a comparator the
+// breakpoint manager has free stops the CPU where it should halt.
+//   Step over: LCALL/ACALL -> breakpoint on the return address, else one step.
+//   Step out:  return address from the stack (the first entry above SP that
+//              follows a call, pushed registers are skipped).
+//   Run to:    breakpoint on the address.
+// A hit with SP above the caller's frame (recursion) resumes again. After
+// RUN_WAIT_MS the call returns RUN_RUNNING; the breakpoint then stays armed
+// until the next debugger command (runControlDisarm).
+// All functions need the link held and the CPU halted.
+
+const uint32_t RUN_WAIT_MS = 100;      // Longest wait for the halt inside a request
+
+// RUN_NO_BREAKPOINT: all four comparators hold user breakpoints
+enum RunResult : uint8_t { RUN_HALTED, RUN_RUNNING, RUN_NO_RETURN, RUN_NO_BREAKPOINT };
+
+RunResult stepOver();
+RunResult stepOut();                   // RUN_NO_RETURN = no return address found on the stack
+RunResult runTo(uint16_t address);     // PC in the current code bank
+void runControlDisarm();               // Removes a temporary breakpoint left armed
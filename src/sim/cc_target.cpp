@@ -0,0 +1,628 @@
+#include "cc_target.h"
+#include <string.h>
+
+//                                  name          id    rev   flash    page  cpu Hz     page erase  chip erase  word write
+const CCTargetConfig CC2530F256 = { "CC2530F256", 0xA5, 0x24, 262144, 2048, 4, 32000000, 20000,      20000,      20 };
+const CCTargetConfig CC2531F256 = { "CC2531F256", 0xB5, 0x24, 262144, 2048, 4, 32000000, 20000,      20000,      20 };
+const CCTargetConfig CC1110F32  = { "CC1110F32",  0x01, 0x04, 32768,  1024, 2, 26000000, 20000,      20000,      20 };
+
+// --- SFR addresses ---
+enum : uint8_t {
+    SFR_SP = 0x81, SFR_DPL = 0x82, SFR_DPH = 0x83, SFR_MPAGE = 0x93,
+    SFR_FWT = 0xAB, SFR_FADDRL = 0xAC, SFR_FADDRH = 0xAD, SFR_FCTL = 0xAE, SFR_FWDATA = 0xAF,
+    SFR_SLEEP = 0xBE, SFR_MEMCTR = 0xC7, SFR_PSW = 0xD0, SFR_ACC = 0xE0, SFR_B = 0xF0
+};
+enum : uint8_t { PSW_CY = 0x80, PSW_AC = 0x40, PSW_OV = 0x04, PSW_P = 0x01 };
+
+// Debug status byte (READ_STATUS)
+enum : uint8_t {
+    STAT_ERASE_DONE = 0x80, STAT_CPU_HALTED = 0x20, STAT_PM0 = 0x10,
+    STAT_HALT_STATUS = 0x08, STAT_OSC_STABLE = 0x02
+};
+
+const uint32_t RUN_BUDGET = 10000000; // Instructions per RESUME before the core counts as "running"
+
+// 8051 instruction length in bytes
+static uint8_t insnLength(uint8_t op) {
+    if((op & 0x0F) == 0x01) return 2; // AJMP / ACALL
+    switch(op) {
+        case 0x02: case 0x10: case 0x12: case 0x20: case 0x30: case 0x43: case 0x53:
+        case 0x63: case 0x75: case 0x85: case 0x90: case 0xB4: case 0xB5: case 0xD5:
+            return 3;
+        case 0x05: case 0x15: case 0x24: case 0x25: case 0x34: case 0x35: case 0x40:
+        case 0x42: case 0x44: case 0x45: case 0x50: case 0x52: case 0x54: case 0x55:
+        case 0x60: case 0x62: case 0x64: case 0x65: case 0x70: case 0x72: case 0x74:
+        case 0x76: case 0x77: case 0x80: case 0x82: case 0x86: case 0x87: case 0x92:
+        case 0x94: case 0x95: case 0xA0: case 0xA2: case 0xA6: case 0xA7: case 0xB0:
+        case 0xB2: case 0xC0: case 0xC2: case 0xC5: case 0xD0: case 0xD2: case 0xE5:
+        case 0xF5:
+            return 2;
+    }
+    if(op >= 0xB6 && op <= 0xBF) return 3; // CJNE @Ri / Rn, #data, rel
+    if((op >= 0x78 && op <= 0x7F) || (op >= 0x88 && op <= 0x8F) ||
+       (op >= 0xA8 && op <= 0xAF) || (op >= 0xD8 && op <= 0xDF)) return 2;
+    return 1;
+}
+
+CCTarget::CCTarget(const CCTargetConfig &cfg)
+    : _cfg(cfg), _xdata(65536, 0), _info(2048, 0xFF), _flash(cfg.flashSize, 0xFF)
+{
+    memset(_bp, 0, sizeof(_bp));
+    memset(_idata, 0, sizeof(_idata));
+    reset(false);
+}
+
+void CCTarget::attach(uint8_t cc, uint8_t dd, uint8_t reset)
+{
+    _ccPin = cc;
+    _ddPin = dd;
+    _resetPin = reset;
+}
+
+// --- PIN LEVEL ---
+
+void CCTarget::pinMode(uint8_t pin, uint8_t mode, uint64_t now)
+{
+    if(pin != _ddPin) return;
+    _now = now;
+    bool drives = (mode != 0x01); // INPUT = host releases DD
+    if(drives && !_hostDrives) {
+        _txLen = 0; // Host stopped reading: rest of the answer is dropped
+        _rxBits = 0;
+    }
+    if(!drives && _hostDrives) {
+        _txPos = 0;
+        _txBit = 0;
+    }
+    _hostDrives = drives;
+}
+
+void CCTarget::pinWrite(uint8_t pin, uint8_t level, uint64_t now)
+{
+    _now = now;
+    bool high = level != 0;
+
+    if(pin == _resetPin) {
+        if(!high && _resetLevel) _pulses = 0;
+        if(high && !_resetLevel) reset(_pulses >= 2); // Two DC pulses during reset = debug mode
+        _resetLevel = high;
+    }
+    else if(pin == _ddPin) {
+        _ddLevel = high;
+    }
+    else if(pin == _ccPin) {
+        if(high && !_ccLevel) {
+            stats.clockEdges++;
+            if(!_resetLevel) {
+                _pulses++;
+            } else if(_debugMode && _hostDrives) {
+                // Host -> target: sample DD on the rising edge, MSB first
+                _rxShift = (_rxShift << 1) | (_ddLevel ? 1 : 0);
+                if(++_rxBits == 8) {
+                    _rxBits = 0;
+                    receiveByte(_rxShift);
+                }
+            } else if(_debugMode) {
+                // Target -> host: next bit is valid after the rising edge
+                if(_txPos < _txLen) {
+                    _ddOut = (_tx[_txPos] >> (7 - _txBit)) & 1;
+                    if(++_txBit == 8) { _txBit = 0; _txPos++; stats.bytesOut++; }
+                } else {
+                    _ddOut = 1;
+                }
+            }
+        }
+        _ccLevel = high;
+    }
+}
+
+int CCTarget::pinRead(uint8_t pin, uint64_t now)
+{
+    _now = now;
+    if(pin != _ddPin) return 0;
+    if(_hostDrives) return _ddLevel;
+    if(!_debugMode || !_resetLevel) return 1; // Nobody drives the line: pulled high
+    return _ddOut;
+}
+
+// --- DEBUG INTERFACE ---
+
+void CCTarget::reset(bool debug)
+{
+    _debugMode = debug;
+    _halted = debug;
+    _cpuBusyNs = 0;
+    _cmdLen = 0;
+    _rxBits = 0;
+    _txLen = 0;
+    _config = 0;
+    _pc = 0;
+    memset(_bpEnabled, 0, sizeof(_bpEnabled)); // Debug unit is reset too
+    memset(_sfr, 0, sizeof(_sfr));
+    _sfr[SFR_SP - 0x80] = 0x07;
+    _flashWrite = false;
+    _wordPos = 0;
+}
+
+static uint32_t probability(double rate)
+{
+    return (rate <= 0) ? 0 : (rate >= 1) ? 0xFFFFFFFF : (uint32_t)(rate * 4294967296.0);
+}
+
+void CCTarget::setBitErrorRate(double rate, uint32_t seed)
+{
+    _errorThreshold = probability(rate);
+    _errorSeed = seed;
+}
+
+void CCTarget::setWeakWriteRate(double rate)
+{
+    _weakThreshold = probability(rate);
+}
+
+// Deterministic random events, same sequence for the same seed
+uint32_t CCTarget::draw()
+{
+    _errorSeed = _errorSeed * 1664525 + 1013904223;
+    return _errorSeed;
+}
+
+bool CCTarget::chance(uint32_t threshold)
+{
+    return threshold && draw() < threshold;
+}
+
+uint8_t CCTarget::noise(uint8_t b)
+{
+    for(uint8_t bit = 0; _errorThreshold && bit < 8; bit++) {
+        if(chance(_errorThreshold)) { b ^= 1 << bit; stats.bitErrors++; }
+    }
+    return b;
+}
+
+void CCTarget::receiveByte(uint8_t b)
+{
+    stats.bytesIn++;
+    // Only the data operand of MOV A,#data is disturbed: a flipped opcode or
+    // command byte would be a different operation, not a corrupted transfer
+    if(_cmdLen == 2 && (_cmd[0] & 0xFC) == 0x54 && _cmd[1] == 0x74) b = noise(b);
+    _cmd[_cmdLen++] = b;
+    // Bits 1:0 of the command byte = number of following bytes
+    if(_cmdLen == 1 + (_cmd[0] & 0x03)) {
+        executeCommand();
+        _cmdLen = 0;
+    }
+}
+
+void CCTarget::respond(uint8_t b0)
+{
+    _tx[0] = noise(b0);
+    _txLen = 1;
+    _txPos = 0;
+    _txBit = 0;
+}
+
+void CCTarget::respond(uint8_t b0, uint8_t b1)
+{
+    respond(b0);
+    _tx[1] = noise(b1);
+    _txLen = 2;
+}
+
+uint8_t CCTarget::status()
+{
+    uint8_t s = STAT_PM0 | STAT_OSC_STABLE;
+    if(_now >= _eraseDoneNs) s |= STAT_ERASE_DONE;
+    if(_halted && _now >= _cpuBusyNs) s |= STAT_CPU_HALTED | STAT_HALT_STATUS;
+    return s;
+}
+
+void CCTarget::executeCommand()
+{
+    uint8_t cmd = _cmd[0];
+
+    if((cmd & 0xFC) == 0x54) { // DEBUG_INSTR (1-3 bytes)
+        stats.injected++;
+        uint8_t insn[3] = { 0, 0, 0 };
+        for(uint8_t i = 1; i < _cmdLen; i++) insn[i - 1] = _cmd[i];
+        respond(step(insn, true));
+        return;
+    }
+
+    stats.commands++;
+    switch(cmd & 0xF8) {
+        case 0x10: // CHIP_ERASE
+            memset(_flash.data(), 0xFF, _flash.size());
+            _eraseDoneNs = _now + (uint64_t)_cfg.chipEraseUs * 1000;
+            stats.chipErases++;
+            respond(status());
+            break;
+        case 0x18: // WR_CONFIG
+            _config = _cmd[1];
+            respond(status());
+            break;
+        case 0x20: // RD_CONFIG
+            respond(_config);
+            break;
+        case 0x28: // GET_PC
+            respond(_pc >> 8, _pc & 0xFF);
+            break;
+        case 0x38: { // SET_HW_BRKPNT: [bp number | enable | addr 17:16], addr high, addr low
+            uint8_t n = (_cmd[1] >> 3) & 0x03;
+            _bpEnabled[n] = (_cmd[1] & 0x04) != 0;
+            _bp[n] = (_cmd[2] << 8) | _cmd[3];
+            respond(status());
+            break;
+        }
+        case 0x40: // HALT
+            _halted = true;
+            _cpuBusyNs = 0;
+            respond(status());
+            break;
+        case 0x48: // RESUME
+            run(RUN_BUDGET);
+            respond(status());
+            break;
+        case 0x58: { // STEP_INSTR
+            uint8_t insn[3] = { fetch(_pc), fetch(_pc + 1), fetch(_pc + 2) };
+            stats.executed++;
+            respond(step(insn, false));
+            break;
+        }
+        case 0x68: // GET_CHIP_ID
+            respond(_cfg.chipId, _cfg.revision);
+            break;
+        default: // READ_STATUS and anything unknown
+            respond(status());
+            break;
+    }
+}
+
+// --- MEMORY ---
+
+// Data reads (MOVC): bank 0 fixed, upper half = bank selected in MEMCTR.
+// Smaller parts alias, which is what detect_flash_size() looks for.
+uint8_t CCTarget::codeRead(uint16_t addr)
+{
+    uint32_t phys = addr;
+    if(addr >= 0x8000) phys = (uint32_t)(_sfr[SFR_MEMCTR - 0x80] & 0x07) * 0x8000 + (addr - 0x8000);
+    return _flash[phys % _flash.size()];
+}
+
+// Info page while WR_CONFIG bit 0 is set; the first 256 bytes mirror IDATA (see read_r0_r7)
+uint8_t CCTarget::xdataRead(uint16_t addr)
+{
+    if((_config & 0x01) && addr < _info.size()) return _info[addr];
+    if(addr < 0x100) return _idata[addr];
+    return _xdata[addr];
+}
+
+void CCTarget::xdataWrite(uint16_t addr, uint8_t val)
+{
+    if((_config & 0x01) && addr < _info.size()) { _info[addr] = val; return; }
+    if(addr < 0x100) { _idata[addr] = val; return; }
+    _xdata[addr] = val;
+}
+
+uint8_t CCTarget::dirRead(uint8_t addr)
+{
+    if(addr < 0x80) return _idata[addr];
+    switch(addr) {
+        case SFR_FCTL: return (flashBusy() ? 0xC0 : 0x00) | (_flashWrite ? 0x02 : 0x00);
+        case SFR_SLEEP: return 0x60; // Oscillators stable
+    }
+    return _sfr[addr - 0x80];
+}
+
+void CCTarget::dirWrite(uint8_t addr, uint8_t val)
+{
+    if(addr < 0x80) { _idata[addr] = val; return; }
+    switch(addr) {
+        case SFR_FCTL: flashControl(val); return;
+        case SFR_FWDATA: flashData(val); return;
+    }
+    _sfr[addr - 0x80] = val;
+}
+
+bool CCTarget::bitRead(uint8_t bit)
+{
+    uint8_t addr = (bit < 0x80) ? 0x20 + (bit >> 3) : (bit & 0xF8);
+    return (dirRead(addr) >> (bit & 7)) & 1;
+}
+
+void CCTarget::bitWrite(uint8_t bit, bool val)
+{
+    uint8_t addr = (bit < 0x80) ? 0x20 + (bit >> 3) : (bit & 0xF8);
+    uint8_t mask = 1 << (bit & 7);
+    uint8_t v = dirRead(addr);
+    dirWrite(addr, val ? (v | mask) : (v & ~mask));
+}
+
+uint8_t& CCTarget::reg(uint8_t n)
+{
+    return _idata[(_sfr[SFR_PSW - 0x80] & 0x18) + n];
+}
+
+uint16_t CCTarget::dptr()
+{
+    return (_sfr[SFR_DPH - 0x80] << 8) | _sfr[SFR_DPL - 0x80];
+}
+
+void CCTarget::setDptr(uint16_t v)
+{
+    _sfr[SFR_DPH - 0x80] = v >> 8;
+    _sfr[SFR_DPL - 0x80] = v & 0xFF;
+}
+
+void CCTarget::push(uint8_t v)
+{
+    uint8_t &sp = _sfr[SFR_SP - 0x80];
+    _idata[++sp] = v;
+}
+
+uint8_t CCTarget::pop()
+{
+    uint8_t &sp = _sfr[SFR_SP - 0x80];
+    return _idata[sp--];
+}
+
+// --- FLASH CONTROLLER ---
+
+bool CCTarget::flashBusy()
+{
+    return _now < _flashBusyNs;
+}
+
+void CCTarget::flashControl(uint8_t val)
+{
+    _sfr[SFR_FCTL - 0x80] = val;
+    uint32_t addr = ((_sfr[SFR_FADDRH - 0x80] << 8) | _sfr[SFR_FADDRL - 0x80]) * _cfg.wordSize; // Word address
+    if(val & 0x01) { // ERASE: page containing FADDR
+        uint32_t page = (addr % _flash.size()) / _cfg.pageSize * _cfg.pageSize;
+        memset(&_flash[page], 0xFF, _cfg.pageSize);
+        _flashBusyNs = _now + (uint64_t)_cfg.pageEraseUs * 1000;
+        stats.pageErases++;
+    }
+    _flashWrite = (val & 0x02) != 0;
+    _wordPos = 0;
+}
+
+// FWDATA: every complete word is programmed and advances FADDR
+void CCTarget::flashData(uint8_t val)
+{
+    if(!_flashWrite) return;
+    _wordBuf[_wordPos++] = val;
+    if(_wordPos < _cfg.wordSize) return;
+    _wordPos = 0;
+
+    uint16_t faddr = (_sfr[SFR_FADDRH - 0x80] << 8) | _sfr[SFR_FADDRL - 0x80];
+    uint32_t addr = ((uint32_t)faddr * _cfg.wordSize) % _flash.size();
+    if(chance(_weakThreshold)) {
+        uint32_t r = draw(); // The hit itself leaves the high bits 0: own draw for the position
+        _wordBuf[(r >> 24) % _cfg.wordSize] |= 1 << ((r >> 16) & 7); // This bit stays 1
+        stats.weakWrites++;
+    }
+    for(uint8_t i = 0; i < _cfg.wordSize; i++) {
+        _flash[addr + i] &= _wordBuf[i]; // Programming only clears bits
+    }
+    faddr++;
+    _sfr[SFR_FADDRH - 0x80] = faddr >> 8;
+    _sfr[SFR_FADDRL - 0x80] = faddr & 0xFF;
+    _flashBusyNs = _now + (uint64_t)_cfg.wordWriteUs * 1000;
+    stats.flashWords++;
+}
+
+// --- 8051 CORE ---
+
+bool CCTarget::hitBreakpoint(uint16_t addr)
+{
+    for(uint8_t i = 0; i < 4; i++) if(_bpEnabled[i] && _bp[i] == addr) return true;
+    return false;
+}
+
+// Instruction fetches above 0xF000 come from SRAM, where the flash loader
+// of write_code_memory() is placed
+uint8_t CCTarget::fetch(uint16_t addr)
+{
+    return (addr >= 0xF000) ? _xdata[addr] : codeRead(addr);
+}
+
+// Runs resumed code on the core's own clock (approximation: one cycle per code byte)
+void CCTarget::run(uint32_t maxInstructions)
+{
+    uint64_t start = _now;
+    uint64_t cycles = 0;
+    _halted = false;
+
+    for(uint32_t i = 0; i < maxInstructions; i++) {
+        if(i > 0 && hitBreakpoint(_pc)) { _halted = true; break; }
+        uint8_t insn[3] = { fetch(_pc), fetch(_pc + 1), fetch(_pc + 2) };
+        if(insn[0] == 0xA5) { _halted = true; break; } // Software breakpoint
+        cycles += insnLength(insn[0]);
+        step(insn, false);
+        stats.executed++;
+        _now = start + cycles * 1000000000ULL / _cfg.cpuHz;
+    }
+
+    // Halt is reported once the host clock has caught up with the core
+    _cpuBusyNs = _halted ? _now : 0;
+    _now = start;
+}
+
+void CCTarget::add(uint8_t v, bool carry)
+{
+    uint8_t &acc = _sfr[SFR_ACC - 0x80];
+    uint8_t &psw = _sfr[SFR_PSW - 0x80];
+    uint8_t c = (carry && (psw & PSW_CY)) ? 1 : 0;
+    uint16_t r = acc + v + c;
+    psw &= ~(PSW_CY | PSW_AC | PSW_OV);
+    if(r > 0xFF) psw |= PSW_CY;
+    if((acc & 0x0F) + (v & 0x0F) + c > 0x0F) psw |= PSW_AC;
+    if(~(acc ^ v) & (acc ^ r) & 0x80) psw |= PSW_OV;
+    acc = r & 0xFF;
+}
+
+void CCTarget::subb(uint8_t v)
+{
+    uint8_t &acc = _sfr[SFR_ACC - 0x80];
+    uint8_t &psw = _sfr[SFR_PSW - 0x80];
+    uint8_t c = (psw & PSW_CY) ? 1 : 0;
+    int r = acc - v - c;
+    psw &= ~(PSW_CY | PSW_AC | PSW_OV);
+    if(r < 0) psw |= PSW_CY;
+    if((acc & 0x0F) < (v & 0x0F) + c) psw |= PSW_AC;
+    if((acc ^ v) & (acc ^ r) & 0x80) psw |= PSW_OV;
+    acc = r & 0xFF;
+}
+
+// Executes one instruction. Injected instructions (DEBUG_INSTR) do not
+// advance the PC, only jumps and calls change it. Returns the accumulator.
+uint8_t CCTarget::step(const uint8_t* insn, bool injected)
+{
+    uint8_t op = insn[0], a1 = insn[1], a2 = insn[2];
+    uint16_t next = injected ? _pc : (uint16_t)(_pc + insnLength(op));
+    uint8_t &acc = _sfr[SFR_ACC - 0x80];
+    uint8_t &psw = _sfr[SFR_PSW - 0x80];
+    uint8_t &b = _sfr[SFR_B - 0x80];
+    _pc = next;
+
+    auto jump = [&](int8_t rel) { _pc = next + rel; };
+    auto setCarry = [&](bool c) { psw = c ? (psw | PSW_CY) : (psw & ~PSW_CY); };
+    bool carry = (psw & PSW_CY) != 0;
+
+    uint8_t lo = op & 0x0F;
+    if(lo >= 4 && op != 0xA5) {
+        // Regular columns: 4 = #data (or A), 5 = direct, 6/7 = @R0/@R1, 8-F = R0-R7
+        auto rd = [&]() -> uint8_t {
+            if(lo == 4) return a1;
+            if(lo == 5) return dirRead(a1);
+            if(lo < 8) return _idata[reg(lo & 1)];
+            return reg(lo & 7);
+        };
+        auto wr = [&](uint8_t v) {
+            if(lo == 5) dirWrite(a1, v);
+            else if(lo < 8) _idata[reg(lo & 1)] = v;
+            else reg(lo & 7) = v;
+        };
+        // Immediate operand of CJNE / MOV #data for the register columns
+        uint8_t imm = (lo == 5) ? a2 : a1;
+
+        switch(op >> 4) {
+            case 0x0: if(lo == 4) acc++; else wr(rd() + 1); break;   // INC
+            case 0x1: if(lo == 4) acc--; else wr(rd() - 1); break;   // DEC
+            case 0x2: add(rd(), false); break;                       // ADD
+            case 0x3: add(rd(), true); break;                        // ADDC
+            case 0x4: acc |= rd(); break;                            // ORL A,
+            case 0x5: acc &= rd(); break;                            // ANL A,
+            case 0x6: acc ^= rd(); break;                            // XRL A,
+            case 0x7:                                                // MOV ..., #data
+                if(lo == 4) acc = a1;
+                else wr(imm);
+                break;
+            case 0x8:
+                if(lo == 4) { // DIV AB
+                    psw &= ~(PSW_CY | PSW_OV);
+                    if(b == 0) psw |= PSW_OV;
+                    else { uint8_t q = acc / b; b = acc % b; acc = q; }
+                }
+                else if(lo == 5) dirWrite(a2, dirRead(a1)); // MOV dir, dir (source first)
+                else dirWrite(a1, rd());                    // MOV dir, @Ri / Rn
+                break;
+            case 0x9: subb(rd()); break;                             // SUBB
+            case 0xA:
+                if(lo == 4) { // MUL AB
+                    uint16_t r = acc * b;
+                    acc = r & 0xFF; b = r >> 8;
+                    psw &= ~(PSW_CY | PSW_OV);
+                    if(r > 0xFF) psw |= PSW_OV;
+                }
+                else wr(dirRead(a1));                        // MOV @Ri / Rn, dir
+                break;
+            case 0xB: { // CJNE
+                uint8_t left = (lo <= 5) ? acc : rd();
+                uint8_t right = (lo == 5) ? dirRead(a1) : ((lo == 4) ? a1 : imm);
+                setCarry(left < right);
+                if(left != right) jump((int8_t)a2);
+                break;
+            }
+            case 0xC:
+                if(lo == 4) acc = (acc << 4) | (acc >> 4);   // SWAP A
+                else { uint8_t t = rd(); wr(acc); acc = t; } // XCH
+                break;
+            case 0xD:
+                if(lo == 4) { // DA A
+                    uint16_t r = acc;
+                    if((r & 0x0F) > 9 || (psw & PSW_AC)) r += 0x06;
+                    if(((r >> 4) & 0x1F) > 9 || carry || r > 0xFF) { r += 0x60; psw |= PSW_CY; }
+                    acc = r & 0xFF;
+                }
+                else if(lo == 5) { uint8_t v = dirRead(a1) - 1; dirWrite(a1, v); if(v) jump((int8_t)a2); } // DJNZ dir
+                else if(lo < 8) { // XCHD A, @Ri
+                    uint8_t &m = _idata[reg(lo & 1)];
+                    uint8_t t = m & 0x0F; m = (m & 0xF0) | (acc & 0x0F); acc = (acc & 0xF0) | t;
+                }
+                else { uint8_t &r = reg(lo & 7); if(--r) jump((int8_t)a1); } // DJNZ Rn
+                break;
+            case 0xE: if(lo == 4) acc = 0; else acc = rd(); break;  // CLR A / MOV A,
+            case 0xF: if(lo == 4) acc = ~acc; else wr(acc); break;  // CPL A / MOV ..., A
+        }
+    }
+    else if(lo == 1) { // AJMP / ACALL (11-bit address within the 2K block)
+        uint16_t target = (next & 0xF800) | ((op & 0xE0) << 3) | a1;
+        if(op & 0x10) { push(next & 0xFF); push(next >> 8); }
+        _pc = target;
+    }
+    else switch(op) {
+        case 0x00: break; // NOP
+        case 0x02: _pc = (a1 << 8) | a2; break; // LJMP
+        case 0x12: push(next & 0xFF); push(next >> 8); _pc = (a1 << 8) | a2; break; // LCALL
+        case 0x22: case 0x32: { uint8_t hi = pop(); _pc = (hi << 8) | pop(); break; } // RET / RETI
+        case 0x03: acc = (acc >> 1) | (acc << 7); break; // RR A
+        case 0x23: acc = (acc << 1) | (acc >> 7); break; // RL A
+        case 0x13: { bool c = acc & 1; acc = (acc >> 1) | (carry ? 0x80 : 0); setCarry(c); break; } // RRC A
+        case 0x33: { bool c = acc & 0x80; acc = (acc << 1) | (carry ? 1 : 0); setCarry(c); break; } // RLC A
+        case 0x10: if(bitRead(a1)) { bitWrite(a1, false); jump((int8_t)a2); } break; // JBC
+        case 0x20: if(bitRead(a1)) jump((int8_t)a2); break;  // JB
+        case 0x30: if(!bitRead(a1)) jump((int8_t)a2); break; // JNB
+        case 0x40: if(carry) jump((int8_t)a1); break;        // JC
+        case 0x50: if(!carry) jump((int8_t)a1); break;       // JNC
+        case 0x60: if(acc == 0) jump((int8_t)a1); break;     // JZ
+        case 0x70: if(acc != 0) jump((int8_t)a1); break;     // JNZ
+        case 0x80: jump((int8_t)a1); break;                  // SJMP
+        case 0x73: _pc = dptr() + acc; break;                // JMP @A+DPTR
+        case 0x42: dirWrite(a1, dirRead(a1) | acc); break;   // ORL dir, A
+        case 0x43: dirWrite(a1, dirRead(a1) | a2); break;    // ORL dir, #data
+        case 0x52: dirWrite(a1, dirRead(a1) & acc); break;   // ANL dir, A
+        case 0x53: dirWrite(a1, dirRead(a1) & a2); break;    // ANL dir, #data
+        case 0x62: dirWrite(a1, dirRead(a1) ^ acc); break;   // XRL dir, A
+        case 0x63: dirWrite(a1, dirRead(a1) ^ a2); break;    // XRL dir, #data
+        case 0x72: setCarry(carry || bitRead(a1)); break;    // ORL C, bit
+        case 0xA0: setCarry(carry || !bitRead(a1)); break;   // ORL C, /bit
+        case 0x82: setCarry(carry && bitRead(a1)); break;    // ANL C, bit
+        case 0xB0: setCarry(carry && !bitRead(a1)); break;   // ANL C, /bit
+        case 0x92: bitWrite(a1, carry); break;               // MOV bit, C
+        case 0xA2: setCarry(bitRead(a1)); break;             // MOV C, bit
+        case 0xB2: bitWrite(a1, !bitRead(a1)); break;        // CPL bit
+        case 0xC2: bitWrite(a1, false); break;               // CLR bit
+        case 0xD2: bitWrite(a1, true); break;                // SETB bit
+        case 0xB3: setCarry(!carry); break;                  // CPL C
+        case 0xC3: setCarry(false); break;                   // CLR C
+        case 0xD3: setCarry(true); break;                    // SETB C
+        case 0x83: acc = codeRead(next + acc); break;        // MOVC A, @A+PC
+        case 0x93: acc = codeRead(dptr() + acc); break;      // MOVC A, @A+DPTR
+        case 0x90: setDptr((a1 << 8) | a2); break;           // MOV DPTR, #data16
+        case 0xA3: setDptr(dptr() + 1); break;               // INC DPTR
+        case 0xC0: push(dirRead(a1)); break;                 // PUSH
+        case 0xD0: dirWrite(a1, pop()); break;               // POP
+        case 0xE0: acc = xdataRead(dptr()); break;           // MOVX A, @DPTR
+        case 0xF0: xdataWrite(dptr(), acc); break;           // MOVX @DPTR, A
+        case 0xE2: case 0xE3: acc = xdataRead((_sfr[SFR_MPAGE - 0x80] << 8) | reg(op & 1)); break; // MOVX A, @Ri
+        case 0xF2: case 0xF3: xdataWrite((_sfr[SFR_MPAGE - 0x80] << 8) | reg(op & 1), acc); break; // MOVX @Ri, A
+        case 0xA5: break; // Breakpoint opcode: only meaningful for resumed code (see run)
+        default: stats.unknownOps++; break;
+    }
+
+    // Parity flag follows the accumulator
+    psw = __builtin_parity(acc) ? (psw | PSW_P) : (psw & ~PSW_P);
+    return acc;
+}
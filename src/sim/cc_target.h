@@ -0,0 +1,143 @@
+#pragma once
+// Simulated CC253x / CC111x debug target (native environment only).
+// Implements the two-wire debug interface on pin level, the debug command
+// set, an 8051 core for injected (DEBUG_INSTR) and resumed code, the flash
+// controller (page erase, word write) and XDATA. All timing is virtual.
+#include <stdint.h>
+#include <vector>
+
+struct CCTargetConfig {
+    const char* name;
+    uint8_t chipId;
+    uint8_t revision;
+    uint32_t flashSize;
+    uint16_t pageSize;
+    uint8_t wordSize;        // Flash word: FADDR unit and write granularity (4 on CC253x, 2 on CC111x)
+    uint32_t cpuHz;          // 8051 clock (instruction timing)
+    uint32_t pageEraseUs;
+    uint32_t chipEraseUs;
+    uint32_t wordWriteUs;    // One flash word
+};
+
+extern const CCTargetConfig CC2530F256;
+extern const CCTargetConfig CC2531F256;
+extern const CCTargetConfig CC1110F32;
+
+struct CCTargetStats {
+    uint64_t clockEdges;     // Rising edges on DC while the target listens
+    uint64_t bytesIn;        // Bytes shifted in (host -> target)
+    uint64_t bytesOut;       // Bytes shifted out (target -> host)
+    uint64_t commands;       // Debug commands (without DEBUG_INSTR)
+    uint64_t injected;       // DEBUG_INSTR frames
+    uint64_t executed;       // Instructions executed by the core after RESUME / STEP
+    uint64_t flashWords;
+    uint64_t pageErases;
+    uint64_t chipErases;
+    uint64_t unknownOps;     // Opcodes the core does not implement (treated as NOP)
+    uint64_t bitErrors;      // Bits flipped by the error injection
+    uint64_t weakWrites;     // Word writes that left a bit unprogrammed
+};
+
+class CCTarget {
+public:
+    explicit CCTarget(const CCTargetConfig &cfg);
+
+    // Pin numbers as passed to CC_interface::begin()
+    void attach(uint8_t cc, uint8_t dd, uint8_t reset);
+
+    // Pin level interface (called by the HAL shim), now = virtual time in ns
+    void pinMode(uint8_t pin, uint8_t mode, uint64_t now);
+    void pinWrite(uint8_t pin, uint8_t level, uint64_t now);
+    int pinRead(uint8_t pin, uint64_t now);
+
+    // Link noise: each bit the target sends, and each payload bit of an
+    // injected MOV A,#data, is flipped with the given probability
+    void setBitErrorRate(double rate, uint32_t seed = 1);
+    // Marginal flash: a word write leaves one bit unprogrammed with this probability
+    void setWeakWriteRate(double rate);
+
+    // Backdoor access for the runner
+    std::vector<uint8_t>& flash() { return _flash; }
+    const CCTargetConfig& config() const { return _cfg; }
+    uint16_t pc() const { return _pc; }
+    CCTargetStats stats = {};
+
+private:
+    // --- Debug interface ---
+    void reset(bool debug);
+    void receiveByte(uint8_t b);
+    uint8_t noise(uint8_t b);
+    uint32_t draw();
+    bool chance(uint32_t threshold);
+    void executeCommand();
+    uint8_t status();
+    void respond(uint8_t b0);
+    void respond(uint8_t b0, uint8_t b1);
+
+    // --- 8051 core ---
+    uint8_t step(const uint8_t* insn, bool injected);
+    void run(uint32_t maxInstructions);
+    uint8_t fetch(uint16_t addr);
+    uint8_t codeRead(uint16_t addr);
+    uint8_t xdataRead(uint16_t addr);
+    void xdataWrite(uint16_t addr, uint8_t val);
+    uint8_t dirRead(uint8_t addr);
+    void dirWrite(uint8_t addr, uint8_t val);
+    bool bitRead(uint8_t bit);
+    void bitWrite(uint8_t bit, bool val);
+    uint8_t& reg(uint8_t n);
+    uint16_t dptr();
+    void setDptr(uint16_t v);
+    void push(uint8_t v);
+    uint8_t pop();
+    void add(uint8_t v, bool carry);
+    void subb(uint8_t v);
+    bool hitBreakpoint(uint16_t addr);
+
+    // --- Flash controller ---
+    bool flashBusy();
+    void flashControl(uint8_t val);
+    void flashData(uint8_t val);
+
+    CCTargetConfig _cfg;
+    uint8_t _ccPin = 0xFF, _ddPin = 0xFF, _resetPin = 0xFF;
+
+    // Wire state
+    bool _ccLevel = false, _resetLevel = true, _ddLevel = true;
+    bool _hostDrives = true;   // DD direction as set by the host
+    bool _debugMode = false;
+    uint8_t _pulses = 0;       // DC pulses while RESET is low
+    uint8_t _rxShift = 0, _rxBits = 0;
+    uint32_t _errorThreshold = 0, _errorSeed = 1; // Per-bit probability scaled to 2^32
+    uint32_t _weakThreshold = 0;
+    uint8_t _cmd[4];
+    uint8_t _cmdLen = 0;
+    uint8_t _tx[2];
+    uint8_t _txLen = 0, _txPos = 0, _txBit = 0;
+    uint8_t _ddOut = 1;
+
+    // Debug state
+    bool _halted = true;
+    uint8_t _config = 0;
+    uint64_t _eraseDoneNs = 0;
+    uint64_t _cpuBusyNs = 0;   // Resumed code still running until then
+    uint16_t _bp[4];
+    bool _bpEnabled[4] = {};
+
+    // Time: host time while halted, core time while running
+    uint64_t _now = 0;
+
+    // Core state
+    uint16_t _pc = 0;
+    uint8_t _sfr[128];
+    uint8_t _idata[256];
+    std::vector<uint8_t> _xdata;
+    std::vector<uint8_t> _info;
+    std::vector<uint8_t> _flash;
+
+    // Flash controller
+    uint64_t _flashBusyNs = 0;
+    bool _flashWrite = false;
+    uint8_t _wordBuf[4];
+    uint8_t _wordPos = 0;
+};
@@ -0,0 +1,77 @@
+#pragma once
+// Host replacement for the parts of Arduino-ESP32 (and FreeRTOS) used by the
+// flasher core. Only compiled into the "native" environment: the GPIO calls
+// are routed to the simulated CC target, time is virtual (see sim_hal.cpp).
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT  0x01
+#define OUTPUT 0x03
+#define HEX 16
+#define DEC 10
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// --- GPIO (-> CCTarget) ---
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+// --- Time (virtual, advanced by the delays) ---
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+unsigned long millis();
+unsigned long micros();
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// --- ESP ---
+class EspClass {
+public:
+    uint32_t getCycleCount();                   // Virtual CCOUNT at 240 MHz
+    uint32_t getCpuFreqMHz() { return 240; }
+};
+extern EspClass ESP;
+
+// --- PSRAM (present with simPsram, see sim_hal.h) ---
+bool psramFound();
+void* ps_malloc(size_t size);
+
+// --- Print ---
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size) {
+        size_t n = 0;
+        while(size--) n += write(*buffer++);
+        return n;
+    }
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// --- FreeRTOS ---
+// Tasks run synchronously inside xTaskCreate(), vTaskDelete(NULL) ends them.
+// That keeps a simulated job deterministic: one job = one call.
+typedef void (*TaskFunction_t)(void *);
+typedef void* TaskHandle_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+#define pdPASS 1
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                       void* parameter, UBaseType_t priority, TaskHandle_t* handle);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(uint32_t ticks); // 1 tick = 1 ms (as configured on the ESP32)
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 0; }
+
+typedef struct { int unused; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
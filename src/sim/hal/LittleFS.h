@@ -0,0 +1,38 @@
+#pragma once
+// Host replacement for LittleFS: files live below a host directory
+// (LittleFS.setRoot(), default ".sim_fs").
+#include <Arduino.h>
+#include <string>
+
+class File {
+public:
+    File(FILE* f = nullptr) : _f(f) {}
+    size_t write(const uint8_t* buf, size_t size) { return _f ? fwrite(buf, 1, size, _f) : 0; }
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t read(uint8_t* buf, size_t size) { return _f ? fread(buf, 1, size, _f) : 0; }
+    int read() { uint8_t c; return read(&c, 1) == 1 ? c : -1; }
+    bool seek(uint32_t pos) { return _f && fseek(_f, pos, SEEK_SET) == 0; }
+    size_t position() const { return _f ? ftell(_f) : 0; }
+    size_t size() const;
+    int available() const { return _f ? (int)(size() - position()) : 0; }
+    void flush() { if(_f) fflush(_f); }
+    void close() { if(_f) { fclose(_f); _f = nullptr; } }
+    operator bool() const { return _f != nullptr; }
+private:
+    FILE* _f;
+};
+
+class LittleFSClass {
+public:
+    bool begin(bool formatOnFail = false);
+    void setRoot(const char* dir) { _root = dir; }
+    File open(const char* path, const char* mode = "r");
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+private:
+    std::string hostPath(const char* path) const { return _root + path; }
+    std::string _root = ".sim_fs";
+};
+
+extern LittleFSClass LittleFS;
@@ -0,0 +1,162 @@
+// Host implementation of the Arduino / FreeRTOS / LittleFS shim (native env).
+// Time is virtual: it only advances through delays and the configured cost
+// of a GPIO access, so a job's duration is reproducible on any machine.
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "sim_hal.h"
+
+LittleFSClass LittleFS;
+EspClass ESP;
+SimClock simClock = {};
+bool simPsram = false;
+
+static CCTarget* target = nullptr;
+
+void simAttachTarget(CCTarget* t)
+{
+    target = t;
+}
+
+// --- GPIO ---
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    simClock.gpioOps++;
+    simClock.nowNs += simClock.gpioCostNs;
+    if(target) target->pinMode(pin, mode, simClock.nowNs);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    simClock.gpioOps++;
+    simClock.nowNs += simClock.gpioCostNs;
+    if(target) target->pinWrite(pin, val, simClock.nowNs);
+}
+
+int digitalRead(uint8_t pin)
+{
+    simClock.gpioOps++;
+    simClock.nowNs += simClock.gpioCostNs;
+    return target ? target->pinRead(pin, simClock.nowNs) : 1;
+}
+
+// --- TIME ---
+
+void delayMicroseconds(uint32_t us)
+{
+    simClock.nowNs += (uint64_t)us * 1000;
+    simClock.linkDelayNs += (uint64_t)us * 1000;
+}
+
+void delay(uint32_t ms)
+{
+    simClock.nowNs += (uint64_t)ms * 1000000;
+    simClock.idleNs += (uint64_t)ms * 1000000;
+}
+
+unsigned long millis()
+{
+    return simClock.nowNs / 1000000;
+}
+
+unsigned long micros()
+{
+    return simClock.nowNs / 1000;
+}
+
+uint32_t EspClass::getCycleCount()
+{
+    return (uint32_t)(simClock.nowNs * 240 / 1000);
+}
+
+// --- PSRAM ---
+
+bool psramFound()
+{
+    return simPsram;
+}
+
+void* ps_malloc(size_t size)
+{
+    return simPsram ? malloc(size) : nullptr;
+}
+
+// --- PRINT ---
+
+size_t Print::printf(const char* format, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if(n < 0) return 0;
+    return write((const uint8_t*)buf, (size_t)n < sizeof(buf) ? n : sizeof(buf) - 1);
+}
+
+// --- FREERTOS ---
+
+struct TaskExit {};
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char*, uint32_t, void* parameter, UBaseType_t, TaskHandle_t* handle)
+{
+    if(handle) *handle = nullptr;
+    try {
+        fn(parameter);
+    } catch(const TaskExit&) {
+        // vTaskDelete(NULL): task finished
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if(task == nullptr) throw TaskExit();
+}
+
+void vTaskDelay(uint32_t ticks)
+{
+    delay(ticks);
+}
+
+// --- LITTLEFS ---
+
+size_t File::size() const
+{
+    if(!_f) return 0;
+    struct stat st;
+    fflush(_f);
+    return (fstat(fileno(_f), &st) == 0) ? st.st_size : 0;
+}
+
+bool LittleFSClass::begin(bool)
+{
+    mkdir(_root.c_str(), 0755);
+    struct stat st;
+    return stat(_root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+File LittleFSClass::open(const char* path, const char* mode)
+{
+    const char* hostMode = (mode[0] == 'w') ? "wb" : (mode[0] == 'a') ? "ab" : "rb";
+    return File(fopen(hostPath(path).c_str(), hostMode));
+}
+
+bool LittleFSClass::exists(const char* path)
+{
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool LittleFSClass::remove(const char* path)
+{
+    return ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool LittleFSClass::rename(const char* from, const char* to)
+{
+    return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+#include "cc_target.h"
+
+// Virtual clock of the native build
+struct SimClock {
+    uint64_t nowNs;
+    uint64_t gpioCostNs;   // Cost of one pinMode/digitalWrite/digitalRead (ESP32-S3: ~50-100 ns)
+    uint64_t gpioOps;
+    uint64_t linkDelayNs;  // Spent in delayMicroseconds() (clock half periods)
+    uint64_t idleNs;       // Spent in delay() / vTaskDelay()
+};
+
+extern SimClock simClock;
+extern bool simPsram;      // psramFound() result (runner option --psram)
+
+// Route the GPIO calls of CC_interface to a simulated target
+void simAttachTarget(CCTarget* t);
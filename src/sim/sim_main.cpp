@@ -0,0 +1,272 @@
+// Native runner: flashes, verifies and dumps a synthetic image on the
+// simulated target with the unmodified flasher core and reports the cost
+// on the wire. Exit code != 0 if a job fails or the data does not match.
+//
+//   pio run -e native && .pio/build/native/program [options]
+//     --chip cc2530|cc2531|cc1110   Target (default cc2530)
+//     --size <bytes>                Synthetic image size (default 32768)
+//     --image <file>                Use a firmware file instead
+//     --delay <us>                  Debug clock half period (default 5)
+//     --gpio-ns <ns>                Cost of one GPIO access (default 80)
+//     --jobs flash,verify,dump      Jobs to run, in this order
+//     --start <addr> --length <n>   Address range of the jobs (image byte 0 = start)
+//     --preserve <start+len,...>    Regions kept by the flash job (the flash is pre-filled
+//                                   with a pattern that has to survive there)
+//     --fs <dir>                    Host directory used as LittleFS (default .sim_fs)
+//     --psram                       Board with PSRAM: image and dump are kept in memory
+//     --metrics                     Print the Prometheus metrics afterwards
+//     --bit-errors <rate>           Flip bits on the debug link with this probability (e.g. 1e-5)
+//     --weak-writes <rate>          Flash word writes that leave a bit unprogrammed (e.g. 1e-4)
+//     --trace <file>                Write the link trace of the last job (*.vcd = VCD, else frame log)
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "cc_interface.h"
+#include "flasher_controller.h"
+#include "metrics.h"
+#include "link_trace.h"
+#include "image_store.h"
+#include "crc32.h"
+#include "sim_hal.h"
+
+// Same pins as the firmware (see main.cpp)
+#define PIN_CC_CLK  4
+#define PIN_CC_DATA 5
+#define PIN_CC_RST  6
+
+class StdoutPrint : public Print {
+public:
+    size_t write(uint8_t c) override { return fwrite(&c, 1, 1, stdout); }
+    size_t write(const uint8_t* buf, size_t size) override { return fwrite(buf, 1, size, stdout); }
+};
+
+static bool writeImage(ImageSlot slot, const std::vector<uint8_t> &data) {
+    ImageFile f;
+    if(!f.open(slot, "w")) return false;
+    bool ok = f.write(data.data(), data.size()) == data.size();
+    f.close();
+    return ok;
+}
+
+// Dump as served by /download/dump.bin
+static std::vector<uint8_t> downloadDump(bool gzip) {
+    std::vector<uint8_t> data;
+    DumpReader reader(gzip);
+    if(!reader) return data;
+    uint8_t buf[1460];
+    size_t n;
+    while((n = reader.read(buf, sizeof(buf))) > 0) data.insert(data.end(), buf, buf + n);
+    return data;
+}
+
+// gzip trailer: CRC-32 and size of the uncompressed data
+static bool gzipMatches(const std::vector<uint8_t> &gz, const uint8_t* data, size_t len) {
+    if(gz.size() < 18 || gz[0] != 0x1F || gz[1] != 0x8B) return false;
+    const uint8_t* t = gz.data() + gz.size() - 8;
+    uint32_t crc = t[0] | (t[1] << 8) | (t[2] << 16) | ((uint32_t)t[3] << 24);
+    uint32_t size = t[4] | (t[5] << 8) | (t[6] << 16) | ((uint32_t)t[7] << 24);
+    return crc == crc32_update(0, data, len) && size == len;
+}
+
+static bool readHostFile(const char* path, std::vector<uint8_t> &data) {
+    FILE* f = fopen(path, "rb");
+    if(!f) return false;
+    uint8_t buf[4096];
+    size_t n;
+    while((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return true;
+}
+
+struct JobCost {
+    uint64_t ns, linkNs, idleNs, edges, tx, rx, cmd, instr;
+};
+
+static JobCost snapshot(const CCTarget &t) {
+    return { simClock.nowNs, simClock.linkDelayNs, simClock.idleNs, t.stats.clockEdges,
+             linkMetrics.bytesTx, linkMetrics.bytesRx, linkMetrics.cmdFrames, linkMetrics.instrFrames };
+}
+
+static void printCost(const char* job, bool ok, const JobCost &a, const JobCost &b) {
+    printf("%-7s %-5s %10.1f %10.1f %10.1f %12llu %10llu %10llu %9llu %10llu\n", job, ok ? "OK" : "FAIL",
+           (b.ns - a.ns) / 1e6, (b.linkNs - a.linkNs) / 1e6, (b.idleNs - a.idleNs) / 1e6,
+           (unsigned long long)(b.edges - a.edges), (unsigned long long)(b.tx - a.tx),
+           (unsigned long long)(b.rx - a.rx), (unsigned long long)(b.cmd - a.cmd),
+           (unsigned long long)(b.instr - a.instr));
+}
+
+int main(int argc, char** argv) {
+    const CCTargetConfig* chip = &CC2530F256;
+    uint32_t size = 32768;
+    const char* imagePath = nullptr;
+    uint8_t clkDelay = 5;
+    std::string jobs = "flash,verify,dump";
+    bool printMetrics = false;
+    const char* tracePath = nullptr;
+    double bitErrors = 0, weakWrites = 0;
+    uint32_t start = 0, length = 0;
+    PreserveRegion keep[MAX_PRESERVE_REGIONS];
+    int keepCount = 0;
+    simClock.gpioCostNs = 80;
+
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* val = (i + 1 < argc) ? argv[i + 1] : "";
+        if(!strcmp(arg, "--chip")) {
+            i++;
+            if(!strcmp(val, "cc2530")) chip = &CC2530F256;
+            else if(!strcmp(val, "cc2531")) chip = &CC2531F256;
+            else if(!strcmp(val, "cc1110")) chip = &CC1110F32;
+            else { fprintf(stderr, "Unknown chip: %s\n", val); return 2; }
+        }
+        else if(!strcmp(arg, "--size")) { size = strtoul(val, nullptr, 0); i++; }
+        else if(!strcmp(arg, "--image")) { imagePath = val; i++; }
+        else if(!strcmp(arg, "--delay")) { clkDelay = atoi(val); i++; }
+        else if(!strcmp(arg, "--gpio-ns")) { simClock.gpioCostNs = strtoull(val, nullptr, 0); i++; }
+        else if(!strcmp(arg, "--jobs")) { jobs = val; i++; }
+        else if(!strcmp(arg, "--start")) { start = strtoul(val, nullptr, 0); i++; }
+        else if(!strcmp(arg, "--length")) { length = strtoul(val, nullptr, 0); i++; }
+        else if(!strcmp(arg, "--preserve")) {
+            keepCount = parsePreserveList(val, keep, MAX_PRESERVE_REGIONS); i++;
+            if(keepCount < 0) { fprintf(stderr, "Invalid preserve list: %s\n", val); return 2; }
+        }
+        else if(!strcmp(arg, "--fs")) { LittleFS.setRoot(val); i++; }
+        else if(!strcmp(arg, "--psram")) simPsram = true;
+        else if(!strcmp(arg, "--metrics")) printMetrics = true;
+        else if(!strcmp(arg, "--trace")) { tracePath = val; i++; }
+        else if(!strcmp(arg, "--bit-errors")) { bitErrors = atof(val); i++; }
+        else if(!strcmp(arg, "--weak-writes")) { weakWrites = atof(val); i++; }
+        else { fprintf(stderr, "Unknown option: %s\n", arg); return 2; }
+    }
+
+    // Firmware image: file or deterministic pseudo-random data
+    std::vector<uint8_t> image;
+    if(imagePath) {
+        if(!readHostFile(imagePath, image)) { fprintf(stderr, "Cannot read %s\n", imagePath); return 2; }
+    } else {
+        uint32_t seed = 0x12345678;
+        image.resize(size);
+        for(auto &b : image) { seed = seed * 1103515245 + 12345; b = seed >> 16; }
+    }
+    if(image.empty() || start + image.size() > chip->flashSize) {
+        fprintf(stderr, "Image size %zu does not fit into %s\n", image.size(), chip->name);
+        return 2;
+    }
+
+    if(!LittleFS.begin(true)) { fprintf(stderr, "Cannot create the LittleFS directory\n"); return 2; }
+    LittleFS.remove("/flash.ckpt");
+    initImageStore();
+
+    CCTarget target(*chip);
+    target.attach(PIN_CC_CLK, PIN_CC_DATA, PIN_CC_RST);
+
+    // Expected flash content after the flash job: image, preserved regions on top
+    std::vector<uint8_t> expect(chip->flashSize, 0xFF);
+    bool ranged = start != 0 || length != 0;
+    if(keepCount > 0 || ranged) {
+        for(uint32_t a = 0; a < chip->flashSize; a++) target.flash()[a] = (uint8_t)(a * 7 + (a >> 8));
+    }
+    if(ranged) memcpy(expect.data(), target.flash().data(), chip->flashSize); // Outside the range: untouched
+    size_t imageSpan = (length && length < image.size()) ? length : image.size();
+    memcpy(expect.data() + start, image.data(), imageSpan);
+    for(int i = 0; i < keepCount; i++) {
+        for(uint32_t a = keep[i].start; a < keep[i].start + keep[i].length && a < chip->flashSize; a++) expect[a] = target.flash()[a];
+    }
+    simAttachTarget(&target);
+
+    cc.set_clock_delay(clkDelay);
+    uint16_t id = cc.begin(PIN_CC_CLK, PIN_CC_DATA, PIN_CC_RST);
+    target.setBitErrorRate(bitErrors); // Chip ID above is read without noise
+    target.setWeakWriteRate(weakWrites);
+    initFlasherController();
+
+    printf("Target %s (ID 0x%04X), image %zu bytes in %s, clock delay %u us, GPIO %llu ns\n\n",
+           chip->name, id, image.size(), imageInPsram() ? "PSRAM" : "LittleFS", clkDelay,
+           (unsigned long long)simClock.gpioCostNs);
+    printf("%-7s %-5s %10s %10s %10s %12s %10s %10s %9s %10s\n",
+           "job", "res", "total_ms", "clk_ms", "idle_ms", "edges", "tx_bytes", "rx_bytes", "cmd", "instr");
+
+    bool allOk = true;
+    size_t pos = 0;
+    while(pos <= jobs.size()) {
+        size_t end = jobs.find(',', pos);
+        if(end == std::string::npos) end = jobs.size();
+        std::string job = jobs.substr(pos, end - pos);
+        pos = end + 1;
+        if(job.empty()) continue;
+
+        if(tracePath) traceStart(TRACE_MAX_DEPTH);
+        JobCost before = snapshot(target);
+        bool ok = false;
+        size_t dumpSizes[2] = { 0, 0 }; // Raw, gzip
+
+        if(job == "flash") {
+            writeImage(IMG_FIRMWARE, image);
+            startFlashTask(false, start, length, keep, keepCount);
+            ok = getJobStatus().code == ST_FLASH_OK;
+            // Range and regions are checked byte by byte, a ranged flash also outside the range
+            for(uint32_t a = start; ok && a < start + imageSpan; a++) ok = target.flash()[a] == expect[a];
+            for(uint32_t a = 0; ok && ranged && a < chip->flashSize; a++) ok = target.flash()[a] == expect[a];
+            for(int i = 0; ok && i < keepCount; i++) {
+                for(uint32_t a = keep[i].start; ok && a < keep[i].start + keep[i].length; a++) ok = target.flash()[a] == expect[a];
+            }
+        } else if(job == "verify") {
+            writeImage(IMG_FIRMWARE, image);
+            startVerifyTask(start, length, keep, keepCount);
+            ok = getJobStatus().code == ST_VERIFY_OK;
+        } else if(job == "dump") {
+            startDumpTask(start, length);
+            size_t expected = length ? length : chip->flashSize - start;
+            const uint8_t* flash = target.flash().data() + start;
+            std::vector<uint8_t> gz = downloadDump(true);
+            ok = getJobStatus().code == ST_DUMP_READY && gzipMatches(gz, flash, expected);
+            if(ok && imageInPsram()) {
+                std::vector<uint8_t> raw = downloadDump(false);
+                ok = raw.size() == expected && memcmp(raw.data(), flash, expected) == 0;
+            }
+            dumpSizes[0] = expected;
+            dumpSizes[1] = gz.size();
+        } else {
+            fprintf(stderr, "Unknown job: %s\n", job.c_str());
+            return 2;
+        }
+
+        printCost(job.c_str(), ok, before, snapshot(target));
+        if(dumpSizes[0]) printf("        dump.bin %zu bytes, download %zu bytes gzip\n", dumpSizes[0], dumpSizes[1]);
+        if(!ok) {
+            JobStatus st = getJobStatus();
+            printf("        status code 0x%02X at 0x%05lX\n", st.code, (unsigned long)st.addr);
+            allOk = false;
+        }
+        if(bitErrors > 0 || weakWrites > 0) {
+            JobStatus st = getJobStatus();
+            printf("        %u link retries, clock delay now %u us, %u page repairs\n", st.retries, st.clkDelay, st.repairs);
+        }
+    }
+
+    printf("\nTarget: %llu instructions executed, %llu flash words, %llu page / %llu chip erases, %llu unknown opcodes, %llu bit errors, %llu weak writes\n",
+           (unsigned long long)target.stats.executed, (unsigned long long)target.stats.flashWords,
+           (unsigned long long)target.stats.pageErases, (unsigned long long)target.stats.chipErases,
+           (unsigned long long)target.stats.unknownOps, (unsigned long long)target.stats.bitErrors,
+           (unsigned long long)target.stats.weakWrites);
+
+    if(tracePath) {
+        FILE* f = fopen(tracePath, "wb");
+        if(!f) { fprintf(stderr, "Cannot write %s\n", tracePath); return 2; }
+        size_t n = strlen(tracePath);
+        TraceReader reader((n > 4 && !strcmp(tracePath + n - 4, ".vcd")) ? TRACE_VCD : TRACE_LOG);
+        uint8_t buf[1024];
+        while((n = reader.read(buf, sizeof(buf))) > 0) fwrite(buf, 1, n, f);
+        fclose(f);
+    }
+
+    if(printMetrics) {
+        StdoutPrint out;
+        printf("\n");
+        renderMetrics(out);
+    }
+    return allOk ? 0 : 1;
+}
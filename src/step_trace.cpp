@@ -0,0 +1,131 @@
+#include "step_trace.h"
+#include "cc_interface.h"
+#include "flasher_controller.h"
+#include "debug_channel.h"
+#include "halt_watch.h"
+#include "breakpoints.h"
+#include <stdlib.h>
+
+// --- CONFIGURATION ---
+static const uint8_t TRACE_SFRS[] = { 0xE0, 0xD0, 0x82, 0x83 }; // ACC PSW DPL DPH (record order)
+const uint32_t STEP_TRACE_YIELD_MS = 100;
+
+enum StepTraceEnd : uint8_t { STEP_RUNNING, STEP_DONE, STEP_STOPPED, STEP_REACHED, STEP_NO_TARGET };
+static const char* END_NAMES[] = { "running", "done", "stopped", "stop address reached", "no target" };
+
+static uint8_t* buffer = nullptr;
+static size_t bufferSize = 0;
+static volatile bool running = false;
+static volatile bool stopRequested = false;
+static volatile uint8_t readers = 0;
+static uint32_t maxSteps = 0;
+static int32_t stopAddr = -1;
+static uint16_t stopHits = 1;
+static uint8_t recordSize = 2;
+static volatile uint32_t records = 0, elapsedMs = 0;
+static volatile uint8_t endReason = STEP_DONE;
+
+static void putHeader() {
+    uint32_t n = records;
+    buffer[4] = n & 0xFF;
+    buffer[5] = (n >> 8) & 0xFF;
+    buffer[6] = (n >> 16) & 0xFF;
+    buffer[7] = n >> 24;
+}
+
+void task_StepTrace(void * parameter) {
+    uint32_t start = millis(), lastYield = start;
+    uint16_t hits = 0;
+    uint8_t reason = STEP_DONE;
+    uint8_t* rec = buffer + STEP_TRACE_HEADER_SIZE;
+
+    while(records < maxSteps) {
+        if(stopRequested) { reason = STEP_STOPPED; break; }
+        cc.debug_step();
+        uint16_t pc = cc.read_pc();
+        // Open bus reads as all ones: only then the extra status frame
+        if(pc == 0xFFFF && cc.get_status_byte() == 0xFF) { reason = STEP_NO_TARGET; break; }
+        rec[0] = pc & 0xFF;
+        rec[1] = pc >> 8;
+        if(recordSize > 2) cc.read_sfrs(TRACE_SFRS, sizeof(TRACE_SFRS), rec + 2);
+        rec += recordSize;
+        records++;
+        if(stopAddr == pc && ++hits >= stopHits) { reason = STEP_REACHED; break; }
+        if(millis() - lastYield >= STEP_TRACE_YIELD_MS) { vTaskDelay(1); lastYield = millis(); }
+    }
+
+    putHeader();
+    elapsedMs = millis() - start;
+    endReason = reason;
+    running = false;
+    releaseLink();
+    haltWatchKick(); // Debugger clients see the new PC
+    vTaskDelete(NULL);
+}
+
+bool startStepTraceTask(uint32_t steps, int32_t until, uint16_t hits, bool regs) {
+    if(steps == 0 || steps > STEP_TRACE_MAX_STEPS || until > 0xFFFF || hits == 0) return false;
+    if(readers || !acquireLink()) return false;
+    if(!cpuHalted(cc.get_status_byte())) { releaseLink(); return false; }
+
+    uint8_t size = regs ? 2 + sizeof(TRACE_SFRS) : 2;
+    size_t need = STEP_TRACE_HEADER_SIZE + (size_t)steps * size;
+    if(need > bufferSize) {
+        free(buffer);
+        buffer = (uint8_t*)(psramFound() ? ps_malloc(need) : malloc(need));
+        bufferSize = buffer ? need : 0;
+        if(!buffer) { releaseLink(); return false; }
+    }
+    bpNoteStop();
+    uint16_t pc = cc.read_pc();
+    buffer[0] = regs ? STEP_TRACE_REGS : 0;
+    buffer[1] = size;
+    buffer[2] = pc & 0xFF;
+    buffer[3] = pc >> 8;
+
+    recordSize = size;
+    maxSteps = steps;
+    stopAddr = until;
+    stopHits = hits;
+    records = elapsedMs = 0;
+    putHeader();
+    stopRequested = false;
+    endReason = STEP_RUNNING;
+    running = true;
+    xTaskCreate(task_StepTrace, "StepTrace", 4096, NULL, 1, NULL);
+    return true;
+}
+
+bool isStepTraceRunning() {
+    return running;
+}
+
+void stopStepTrace() {
+    if(running) stopRequested = true;
+}
+
+size_t formatStepTraceJSON(char* buf, size_t len) {
+    uint32_t ms = running ? 0 : elapsedMs;
+    return snprintf(buf, len, "{\"running\":%s,\"state\":\"%s\",\"steps\":%lu,\"max_steps\":%lu,"
+                    "\"regs\":%s,\"elapsed_ms\":%lu,\"steps_per_s\":%lu}",
+                    running ? "true" : "false", END_NAMES[endReason], (unsigned long)records,
+                    (unsigned long)maxSteps, recordSize > 2 ? "true" : "false", (unsigned long)ms,
+                    (unsigned long)(ms ? (uint64_t)records * 1000 / ms : 0));
+}
+
+StepTraceReader::StepTraceReader() {
+    readers++;
+    _size = (buffer && !running) ? STEP_TRACE_HEADER_SIZE + (size_t)records * recordSize : 0;
+}
+
+StepTraceReader::~StepTraceReader() {
+    readers--;
+}
+
+size_t StepTraceReader::read(uint8_t* buf, size_t maxLen) {
+    size_t n = _size - _pos;
+    if(n > maxLen) n = maxLen;
+    memcpy(buf, buffer + _pos, n);
+    _pos += n;
+    return n;
+}
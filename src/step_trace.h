@@ -0,0 +1,38 @@
+#pragma once
+#include <Arduino.h>
+
+// --- INSTRUCTION TRACE ---
+// Single-steps the halted CPU up to N times back-to-back on the ESP and
+// records the PC after every step (optionally ACC, PSW and DPTR) into a
+// compact binary buffer, PSRAM if present. A step costs 2 debug frames,
+// 7 with registers. The trace ends after N steps, when the PC reaches the
+// stop address the requested number of times, or when the target is lost.
+//
+// Download (/api/debug/trace.bin), little endian:
+//   Header: [flags][record size][start PC u16][records u32]
+//   Record: [PC u16] + with STEP_TRACE_REGS: [ACC][PSW][DPL][DPH]
+
+const uint8_t STEP_TRACE_REGS = 0x01;         // flags: registers in every record
+const uint32_t STEP_TRACE_MAX_STEPS = 100000;
+const size_t STEP_TRACE_HEADER_SIZE = 8;
+
+// until: stop address (-1 = none), hits: stop on the n-th time the PC reaches it
+// Returns: false = system busy, CPU not halted, bad parameters or out of memory
+bool startStepTraceTask(uint32_t steps, int32_t until, uint16_t hits, bool regs);
+bool isStepTraceRunning();
+void stopStepTrace();                         // Ends a running trace early (trace is kept)
+
+size_t formatStepTraceJSON(char* buf, size_t len);
+
+// Incremental download for chunked HTTP responses. No new trace can start
+// while a reader exists.
+class StepTraceReader {
+public:
+    StepTraceReader();
+    ~StepTraceReader();
+    size_t size() const { return _size; }     // Header + records, 0 = no trace
+    size_t read(uint8_t* buf, size_t maxLen); // 0 = end
+private:
+    size_t _size;
+    size_t _pos = 0;
+};
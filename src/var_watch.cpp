@@ -0,0 +1,204 @@
+#include "var_watch.h"
+#include "cc_interface.h"
+#include "flasher_controller.h"
+#include "debug_channel.h"
+#include "breakpoints.h"
+#include <stdlib.h>
+
+// --- CONFIGURATION ---
+const size_t WATCH_TEXT = 96;                     // Variable list as given (CSV header, status)
+const uint32_t WATCH_YIELD_MS = 100;              // Busy-wait sampling still lets the idle task run
+
+struct WatchSample {
+    uint32_t ms;                                  // Since the start of the watch
+    uint16_t haltUs;                              // CPU stopped for this sample
+    uint16_t value[WATCH_MAX_VARS];
+};
+
+enum WatchEnd : uint8_t { WATCH_RUNNING, WATCH_DONE, WATCH_STOPPED, WATCH_HALTED, WATCH_NO_TARGET };
+static const char* END_NAMES[] = { "running", "done", "stopped", "target halted", "no target" };
+
+static WatchSample* ring = nullptr;
+static PeekItem items[WATCH_MAX_VARS];
+static uint8_t varCount = 0;
+static char varText[WATCH_TEXT] = "";
+static volatile bool running = false;
+static volatile bool stopRequested = false;
+static uint16_t watchHz = 0;
+static uint32_t watchMs = 0;
+// Sample numbers count on across runs: a stream reader notices a new run by runStart
+static volatile uint32_t total = 0, runStart = 0, elapsedMs = 0;
+static volatile uint32_t lastUs = 0, maxUs = 0;
+static uint64_t sumUs = 0;
+static volatile uint8_t endReason = WATCH_DONE;
+
+// "x16:F000,i:30,s:90" -> items; false = syntax error or too many variables
+static bool parseVars(const char* text) {
+    PeekItem parsed[WATCH_MAX_VARS];
+    uint8_t n = 0;
+    const char* p = text;
+    while(*p) {
+        while(*p == ' ') p++;
+        if(n == WATCH_MAX_VARS) return false;
+        PeekItem &it = parsed[n];
+        if(*p == 'x') it.space = PEEK_XDATA;
+        else if(*p == 'i') it.space = PEEK_IDATA;
+        else if(*p == 's') it.space = PEEK_SFR;
+        else return false;
+        p++;
+        it.len = 1;
+        if(!strncmp(p, "16", 2) && it.space != PEEK_SFR) { it.len = 2; p += 2; }
+        if(*p++ != ':') return false;
+        char* end;
+        uint32_t addr = strtoul(p, &end, 16);
+        if(end == p) return false;
+        p = end;
+        uint32_t limit = (it.space == PEEK_XDATA) ? 0x10000 : 0x100;
+        if(addr + it.len > limit || (it.space == PEEK_SFR && addr < 0x80)) return false;
+        it.address = addr;
+        n++;
+        while(*p == ' ') p++;
+        if(*p == ',') p++;
+        else if(*p) return false;
+    }
+    if(n == 0) return false;
+    memcpy(items, parsed, sizeof(parsed));
+    varCount = n;
+    return true;
+}
+
+void task_Watch(void * parameter) {
+    uint32_t period = 1000000UL / watchHz;
+    uint32_t start = millis(), lastYield = start;
+    uint32_t next = micros();
+    uint8_t reason = WATCH_DONE;
+    uint8_t raw[WATCH_MAX_VARS * 2];
+
+    while(millis() - start < watchMs) {
+        if(stopRequested) { reason = WATCH_STOPPED; break; }
+        uint8_t status = cc.get_status_byte();
+        if(status == 0xFF) { reason = WATCH_NO_TARGET; break; }
+        if(cpuHalted(status)) {
+            if(bpFilterHit()) continue;                      // Conditional breakpoint, condition false
+            reason = WATCH_HALTED; break;                    // Not stopped by us: leave it there
+        }
+
+        uint32_t t0 = micros();
+        cc.debug_break();
+        cc.peek_batch(items, varCount, raw);
+        cc.debug_continue();
+        uint32_t us = micros() - t0;
+
+        WatchSample &s = ring[total & (WATCH_RING - 1)];
+        s.ms = millis() - start;
+        s.haltUs = (us > 0xFFFF) ? 0xFFFF : us;
+        const uint8_t* b = raw;
+        for(uint8_t i = 0; i < varCount; i++) {
+            s.value[i] = (items[i].len == 2) ? (b[0] | (b[1] << 8)) : b[0];
+            b += items[i].len;
+        }
+        lastUs = us;
+        if(us > maxUs) maxUs = us;
+        sumUs += us;
+        total++;
+
+        next += period;
+        int32_t wait = (int32_t)(next - micros());
+        if(wait >= 1000) { vTaskDelay(wait / 1000); lastYield = millis(); }
+        else if(wait > 0) delayMicroseconds(wait);
+        else if(wait < -(int32_t)period) next = micros(); // Link slower than the rate: no catch-up burst
+        if(millis() - lastYield >= WATCH_YIELD_MS) { vTaskDelay(1); lastYield = millis(); }
+    }
+
+    elapsedMs = millis() - start;
+    endReason = reason;
+    running = false;
+    releaseLink();
+    vTaskDelete(NULL);
+}
+
+bool startWatchTask(const char* vars, uint16_t hz, uint32_t durationMs) {
+    if(hz == 0 || hz > WATCH_MAX_HZ || durationMs == 0 || durationMs > WATCH_MAX_MS) return false;
+    if(strlen(vars) >= WATCH_TEXT) return false;
+    if(!acquireLink()) return false;
+    if(!parseVars(vars)) { releaseLink(); return false; }
+    if(!ring) ring = (WatchSample*)(psramFound() ? ps_malloc(WATCH_RING * sizeof(WatchSample))
+                                                 : malloc(WATCH_RING * sizeof(WatchSample)));
+    if(!ring) { releaseLink(); return false; }
+    strcpy(varText, vars);
+    runStart = total;
+    elapsedMs = lastUs = maxUs = 0;
+    sumUs = 0;
+    watchHz = hz;
+    watchMs = durationMs;
+    stopRequested = false;
+    endReason = WATCH_RUNNING;
+    running = true;
+    xTaskCreate(task_Watch, "Watch", 4096, NULL, 1, NULL);
+    return true;
+}
+
+bool isWatchRunning() {
+    return running;
+}
+
+void stopWatch() {
+    if(running) stopRequested = true;
+}
+
+size_t formatWatchJSON(char* buf, size_t len) {
+    uint32_t samples = total - runStart;
+    return snprintf(buf, len, "{\"running\":%s,\"state\":\"%s\",\"vars\":\"%s\",\"hz\":%u,\"ms\":%lu,\"elapsed_ms\":%lu,"
+                    "\"samples\":%lu,\"seq\":%lu,\"halt_us\":{\"last\":%lu,\"avg\":%lu,\"max\":%lu}}",
+                    running ? "true" : "false", END_NAMES[endReason], varText, (unsigned)watchHz,
+                    (unsigned long)watchMs, (unsigned long)(running ? 0 : elapsedMs),
+                    (unsigned long)samples, (unsigned long)runStart, (unsigned long)lastUs,
+                    (unsigned long)(samples ? sumUs / samples : 0), (unsigned long)maxUs);
+}
+
+// Oldest sample still in the ring buffer for this run
+static uint32_t firstKept() {
+    return (total - runStart > WATCH_RING) ? total - WATCH_RING : runStart;
+}
+
+size_t formatWatchSamples(char* buf, size_t len, uint32_t &seq) {
+    if(!ring) return 0;
+    uint32_t end = total;
+    if(seq - runStart > end - runStart) seq = runStart;     // Older run (or a sequence from the future)
+    if(seq < firstKept()) seq = firstKept();
+    if(seq == end) return 0;
+    size_t pos = snprintf(buf, len, "{\"seq\":%lu,\"s\":[", (unsigned long)seq);
+    for(; seq != end && pos + 32 + WATCH_MAX_VARS * 7 < len; seq++) {
+        WatchSample s = ring[seq & (WATCH_RING - 1)];
+        if(total - seq > WATCH_RING) continue;              // Overwritten while copying
+        pos += snprintf(buf + pos, len - pos, "%s[%lu,%u", (buf[pos - 1] == '[') ? "" : ",",
+                        (unsigned long)s.ms, s.haltUs);
+        for(uint8_t i = 0; i < varCount; i++) pos += snprintf(buf + pos, len - pos, ",%u", s.value[i]);
+        buf[pos++] = ']';
+    }
+    pos += snprintf(buf + pos, len - pos, "]}");
+    return pos;
+}
+
+void printWatchCSV(Print &out) {
+    out.printf("# %s at %u Hz, %s\n", varText, (unsigned)watchHz, END_NAMES[endReason]);
+    out.print("ms,halt_us");
+    // Column names from the list as given
+    const char* p = varText;
+    for(uint8_t i = 0; i < varCount; i++) {
+        while(*p == ' ') p++;
+        const char* e = strchr(p, ',');
+        size_t n = e ? e - p : strlen(p);
+        while(n && p[n - 1] == ' ') n--;
+        out.printf(",%.*s", (int)n, p);
+        p = e ? e + 1 : p + n;
+    }
+    out.print("\n");
+    if(!ring) return;
+    for(uint32_t seq = firstKept(); seq != total; seq++) {
+        const WatchSample &s = ring[seq & (WATCH_RING - 1)];
+        out.printf("%lu,%u", (unsigned long)s.ms, s.haltUs);
+        for(uint8_t i = 0; i < varCount; i++) out.printf(",%u", s.value[i]);
+        out.print("\n");
+    }
+}
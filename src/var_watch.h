@@ -0,0 +1,34 @@
+#pragma once
+#include <Arduino.h>
+
+// --- LIVE VARIABLE WATCH ---
+// Time series of target variables on the running firmware, without UART
+// prints. At the sample rate the job stops the CPU in place (CMD_HALT),
+// reads all variables in one batch (cc.peek_batch: registers saved once),
+// lets it continue and stores the values with a timestamp in a ring buffer.
+// The halt window (stop to continue, measured on the ESP) is stored with
+// every sample, so the intrusion on radio firmware stays visible.
+// Variables: comma separated, x:<hex> XDATA, i:<hex> IDATA, s:<hex> SFR,
+// x16:/i16: 16-bit little endian, e.g. "x16:F000,i:30,s:90".
+// A CPU that halts by itself ends the watch, unless it is a conditional
+// breakpoint whose condition is false (resumed like the halt watch does).
+
+const uint8_t WATCH_MAX_VARS = 8;
+const uint16_t WATCH_MAX_HZ = 500;
+const uint32_t WATCH_MAX_MS = 3600000;
+const uint16_t WATCH_RING = 1024;             // Samples kept (power of 2)
+
+// Returns: false = system busy, bad variable list or parameters, out of memory
+bool startWatchTask(const char* vars, uint16_t hz, uint32_t durationMs);
+bool isWatchRunning();
+void stopWatch();                             // Ends a running watch early
+
+size_t formatWatchJSON(char* buf, size_t len);
+
+// New samples as JSON for the event stream: {"seq":n,"s":[[ms,halt_us,v0,v1..],..]}.
+// seq = next sample to send, advanced past the samples written (older ones
+// already overwritten are skipped). Returns 0 = nothing new.
+size_t formatWatchSamples(char* buf, size_t len, uint32_t &seq);
+
+// Ring buffer as CSV: ms,halt_us,<variable>...
+void printWatchCSV(Print &out);
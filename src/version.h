@@ -0,0 +1,4 @@
+#pragma once
+
+// Firmware version (reported by /api/system_info and stored with benchmark results)
+#define FW_VERSION "1.1.0"
@@ -120,6 +120,8 @@ const char index_html[] PROGMEM = R"rawliteral(
     .reg-val { color: #fff; }
 
     .hex-toolbar { padding: 8px 15px; background: #252525; border-bottom: 1px solid var(--border); display: flex; gap: 10px; align-items: center; }
+    .range-row { display: flex; align-items: center; gap: 4px; color: #aaa; font-size: 0.85rem; margin: 6px 0; }
+    .range-row span { margin-right: auto; }
     .hex-input { background: #111; border: 1px solid #444; color: white; font-family: monospace; padding: 4px 8px; font-size: 0.9rem; width: 70px; border-radius: 3px; }
     .hex-btn { padding: 4px 12px; font-size: 0.8rem; min-width: auto; }
 
@@ -180,6 +182,7 @@ const char index_html[] PROGMEM = R"rawliteral(
                 <button class="primary" onclick="cmd('init')" data-i18n="btn_init">INIT / RESET</button>
                 <button class="primary" onclick="getChipInfo()" data-i18n="btn_info">INFO PAGE LESEN</button>
                 <button style="background:#444;" onclick="dumpFirmware()" id="btnDump" data-i18n="btn_dump">FLASH AUSLESEN</button>
+                <div class="range-row"><span data-i18n="lbl_range">Bereich</span> 0x<input type="text" id="dumpStart" class="hex-input" placeholder="0"> + 0x<input type="text" id="dumpLen" class="hex-input" data-i18n-ph="ph_range_all" placeholder="alles"></div>
                 <div id="dumpProgCont" class="prog-cont"><div id="dumpProgBar" class="prog-bar"></div></div>
                 <hr style="border:0; border-top:1px solid #333; width:100%; margin:5px 0;">
                 <button class="danger" onclick="lockChip()" data-i18n="btn_lock">LOCK CHIP (PROTECT)</button>
@@ -206,11 +209,14 @@ const char index_html[] PROGMEM = R"rawliteral(
 
         <div class="card">
             <h2 data-i18n="sec_fw">3. Firmware Update</h2>
-            <input type="file" id="hiddenFileInput" accept=".bin" style="display:none" onchange="onFileSelected(this)">
+            <input type="file" id="hiddenFileInput" accept=".bin,.gz" style="display:none" onchange="onFileSelected(this)">
             <div class="btn-group">
                 <button id="btnFlash" class="primary" style="flex:1;" onclick="triggerUpload('FLASH')" data-i18n="btn_flash">FLASHEN</button>
                 <button id="btnVerify" style="flex:1; background:#444;" onclick="triggerUpload('VERIFY')" data-i18n="btn_verify">VERIFIZIEREN</button>
+                <button id="btnResume" class="warn" style="flex:1; display:none;" onclick="resumeFlash()" data-i18n="btn_resume_flash">FORTSETZEN</button>
             </div>       
+            <div class="range-row"><span data-i18n="lbl_range_fw">Ab Adresse</span> 0x<input type="text" id="fwStart" class="hex-input" placeholder="0"> + 0x<input type="text" id="fwLen" class="hex-input" data-i18n-ph="ph_range_all" placeholder="alles"></div>
+            <div class="range-row"><span data-i18n="lbl_preserve" title="0x3F800+0x800, ...">Erhalten</span><input type="text" id="fwPreserve" class="hex-input" style="width:150px;" placeholder="0x3F800+0x800"></div>
             <div id="flashProgCont" class="prog-cont"><div id="flashProgBar" class="prog-bar"></div></div>
             <p id="flashStatusText"></p>
         </div>
@@ -233,6 +239,8 @@ const char index_html[] PROGMEM = R"rawliteral(
                   <button class="danger" onclick="debugCmd('halt')" title="Halt CPU" style="padding:8px 16px; font-size:0.9rem;" data-i18n="btn_halt">&#10074;&#10074; HALT</button>
                   <button class="primary" onclick="debugCmd('resume')" title="Resume CPU" style="padding:8px 16px; font-size:0.9rem;" data-i18n="btn_resume">&#9654; RUN</button>
                   <button onclick="debugCmd('step')" title="Step Into" style="background:#444; border-color:#29b6f6; color:#29b6f6;" data-i18n="btn_step">&#8618; STEP</button>
+                  <button onclick="debugCmd('step_over')" title="Step Over (call runs through)" style="background:#444; border-color:#29b6f6; color:#29b6f6;" data-i18n="btn_step_over">&#8631; STEP OVER</button>
+                  <button onclick="debugCmd('step_out')" title="Step Out (run to the caller)" style="background:#444; border-color:#29b6f6; color:#29b6f6;" data-i18n="btn_step_out">&#8629; STEP OUT</button>
                   <button onclick="cmd('init'); setTimeout(refreshDebug, 500);" title="Reset Connection" style="padding:6px 10px; font-size:0.8rem; background:#333; border:1px solid #555;">INIT</button>
                   <button onclick="getChipInfo()" title="Check Connection ID" style="padding:6px 10px; font-size:0.8rem; background:#333; border:1px solid #555;">INFO</button>
               </div>
@@ -242,8 +250,10 @@ const char index_html[] PROGMEM = R"rawliteral(
                 <div style="display:flex; align-items:center; gap:5px;">
                     <span style="font-size:0.8rem; color:#aaa;">BP:</span>
                     <input type="text" id="bpAddr" placeholder="Addr" class="hex-input" style="width:50px; border-color:#ff4081;">
+                    <input type="text" id="bpCond" placeholder="if (x:F000 == 5)" class="hex-input" style="width:110px; border-color:#ff4081;" title="Condition: x: i: s: x16: i16: &lt;hex&gt; or hits, ==, !=, &lt;, &lt;=, &gt;, &gt;=, changed; join with &amp;&amp;">
                     <button onclick="setBp()" class="hex-btn" style="border-color:#ff4081; color:#ff4081;">SET</button>
                     <button onclick="clearBp()" class="hex-btn" style="color:#888;">CLR</button>
+                    <span id="bpList" style="font-size:0.8rem; color:#ff4081; font-family:monospace;"></span>
                 </div>
               <div style="flex:1;"></div>
               <button onclick="refreshDebug()" data-i18n="btn_refresh">&#x21bb; Refresh</button>
@@ -284,12 +294,29 @@ const char index_html[] PROGMEM = R"rawliteral(
                           <div class="reg-item"><span class="reg-name">P2</span><span class="reg-val" id="r_P2">--</span></div>
                       </div>
                   </div>
+                  <div class="card" style="padding:0; overflow:hidden;">
+                      <h2 style="padding:10px 15px; margin:0; background:#252525; border-bottom:1px solid #333;" data-i18n="sec_watch">Live Watch</h2>
+                      <div style="display:flex; align-items:center; gap:5px; padding:8px;">
+                          <input type="text" id="watchVars" value="x16:F000,i:30" class="hex-input" style="flex:1; min-width:0;" title="x: i: s: x16: i16: &lt;hex&gt;, comma separated (max 8)">
+                          <input type="text" id="watchHz" value="50" class="hex-input" style="width:40px;" title="Samples/s">
+                          <button onclick="varWatchStart()" class="hex-btn">START</button>
+                          <button onclick="varWatchStop()" class="hex-btn" style="color:#888;">STOP</button>
+                      </div>
+                      <canvas id="watchChart" height="120" style="width:100%; height:120px; display:block; background:#111;"></canvas>
+                      <div id="watchInfo" style="padding:4px 8px; font-size:0.75rem; color:#888; font-family:monospace;"></div>
+                  </div>
               </div>
 
               <div class="debug-right">
                   <div class="hex-toolbar">
                       <span style="font-size:0.9rem; font-weight:bold; color:#aaa;" data-i18n="sec_xdata">XDATA MEMORY</span>
                       <div style="flex:1"></div>
+                      <select id="memSpace" class="hex-input" style="width:auto;" onchange="loadMem()">
+                          <option value="xdata">XDATA</option>
+                          <option value="code">CODE</option>
+                          <option value="idata">IDATA</option>
+                          <option value="sfr">SFR</option>
+                      </select>
                       <span style="font-size:0.9rem; color:#888;">Addr: 0x</span>
                       <input type="text" id="memAddr" value="F000" class="hex-input" onkeydown="if(event.key==='Enter') loadMem()">
                       <span style="font-size:0.9rem; color:#888;" data-i18n="lbl_len">Len:</span>
@@ -11,6 +11,19 @@ const char javaScript[] PROGMEM = R"rawliteral(
   let translations = {};
   let lastLogMsg = ""; 
   let viewMode = 'asm'; // oder 'hex'
+  let evtSrc = null;      // Server-Sent Events (/api/events)
+  let statusMode = null;  // Active job view ('DUMP' / 'FLASH') or null
+  let lastJobT0 = -1;     // Start time of the last job seen (stale result filter)
+  let watchT0 = -1;
+
+  // --- JOB STATUS CODES (see flasher_controller.h) ---
+  const JOB_DUMP = 1, JOB_FLASH = 2;
+  const PH_READ = 5, PH_WRITE = 6, PH_VERIFY = 7, PH_RESUME = 8, PH_REPAIR = 10;
+  const ST_READY = 0, ST_BUSY = 1, ST_DUMP_READY = 2, ERR_FIRST = 0x20;
+  const PHASE_KEYS = ['ph_idle','ph_init','ph_detect','ph_prepare','ph_erase','ph_read','ph_write','ph_verify','ph_resume','ph_lock','ph_repair','ph_preserve'];
+  const CODE_KEYS = { 0:'st_ready', 2:'st_dump_ready', 3:'st_flash_ok', 4:'st_verify_ok', 5:'st_erase_ok', 6:'st_lock_ok',
+      0x20:'err_no_response', 0x21:'err_fs_write', 0x22:'err_file_missing', 0x23:'err_no_checkpoint', 0x24:'err_erase',
+      0x25:'err_erase_page', 0x26:'err_write', 0x27:'err_mismatch', 0x28:'err_verify', 0x29:'err_link', 0x2A:'err_range', 0x2B:'err_preserve' };
 
 
   const targets = {
@@ -28,13 +41,24 @@ const char javaScript[] PROGMEM = R"rawliteral(
       let langSel = document.getElementById('langSelect');
       if(langSel) langSel.value = curLang;
 
-      fetch('/api/lang').then(r=>r.json()).then(l => {
-          translations = l; updateTexts(); 
-          fetch('/api/pins').then(r=>r.json()).then(p => { espPins = p; updatePinoutView(); });
-          fetch('/api/system_info').then(r=>r.json()).then(info => { log("System IP: " + info.ip); autoConnect(); });
+      // Two parallel requests: the selected language and everything else (pins, system, chip)
+      Promise.all([loadLang(curLang), fetch('/api/bootstrap').then(r=>r.json())]).then(([_, b]) => {
+          updateTexts();
+          espPins = b.pins; updatePinoutView();
+          log("System IP: " + b.system.ip);
+          if(b.chip) showChipInfo(b.chip); else if(!b.busy) fetch('/api/init').then(getChipInfo);
+          connectEvents();
       }).catch(e=>{ log("Init Error: " + e); });
   };
 
+  // Translations are loaded per language, versioned URLs are cached by the browser
+  const LANG_VER = {}; // Filled in by tools/gzip_assets.py
+  function loadLang(code) {
+      if(translations[code]) return Promise.resolve();
+      return fetch('/api/lang/' + code + (LANG_VER[code] ? '?v=' + LANG_VER[code] : ''))
+          .then(r=>r.json()).then(l => { translations[code] = l; });
+  }
+
   // --- 8051 DISASSEMBLER ENGINE ---
 
 // Mapping: Opcode -> { len: Länge in Bytes, mask: Format-String }
@@ -377,8 +401,14 @@ function disassembleBlock(startAddr, bytes) {
 
   // --- UI HELPER ---
   function t(key) { return (translations[curLang] && translations[curLang][key]) ? translations[curLang][key] : key; }
-  function changeLang(val) { curLang = val; localStorage.setItem('cc_lang', val); updateTexts(); updatePinoutView(); }
-  function updateTexts() { document.querySelectorAll('[data-i18n]').forEach(el => { el.innerText = t(el.dataset.i18n); }); }
+  function changeLang(val) {
+      curLang = val; localStorage.setItem('cc_lang', val);
+      loadLang(val).then(() => { updateTexts(); updatePinoutView(); }).catch(e => log("Lang Error: " + e));
+  }
+  function updateTexts() {
+      document.querySelectorAll('[data-i18n]').forEach(el => { el.innerText = t(el.dataset.i18n); });
+      document.querySelectorAll('[data-i18n-ph]').forEach(el => { el.placeholder = t(el.dataset.i18nPh); });
+  }
 
   function updatePinoutView() {
       const sel = document.getElementById('targetSelect'); if(!sel) return;
@@ -390,8 +420,28 @@ function disassembleBlock(startAddr, bytes) {
       document.getElementById('pinoutContainer').innerHTML = html;
   }
 
+  function hex(v, w) { return v.toString(16).toUpperCase().padStart(w, '0'); }
+
+  // Localized text for a status record
+  function statusText(d) {
+      const notes = [];
+      if(d.retries) notes.push(t('link_retries').replace('{n}', d.retries).replace('{clk}', d.clk));
+      if(d.repairs) notes.push(t('page_repairs').replace('{n}', d.repairs));
+      const link = notes.length ? ' (' + notes.join(', ') + ')' : '';
+      if(d.code === ST_BUSY) {
+          let step = '';
+          if(d.job === JOB_DUMP || d.job === JOB_FLASH) {
+              if(d.phase === PH_READ || d.phase === PH_WRITE || d.phase === PH_RESUME) step = '[1/2] ';
+              else if(d.phase === PH_VERIFY || d.phase === PH_REPAIR) step = '[2/2] ';
+          }
+          return step + t(PHASE_KEYS[d.phase] || 'ph_idle') + (d.addr ? ' @ 0x' + hex(d.addr, 4) : '...') + link;
+      }
+      return t(CODE_KEYS[d.code] || 'err_unknown')
+          .replace('{addr}', '0x' + hex(d.addr, 4)).replace('{exp}', hex(d.exp, 2)).replace('{act}', hex(d.act, 2)) + link;
+  }
+
   // --- LOGGING SYSTEM (DOM BASED) ---
-  function log(msg) {
+  function log(msg, isBusy) {
       const now = new Date();
       const timeSimple = now.toLocaleTimeString(); 
       const timeDetail = timeSimple + "." + String(now.getMilliseconds()).padStart(3, '0');
@@ -404,12 +454,13 @@ function disassembleBlock(startAddr, bytes) {
           // Check if the last line was a "BUSY" update
           const lastDiv = el.lastElementChild;
           
-          if (isBusyUpdate && lastDiv && lastDiv.innerText.includes("BUSY")) {
+          if (isBusyUpdate && lastDiv && lastDiv.dataset.busy) {
               lastDiv.innerText = text;
           } 
           else {
               const div = document.createElement('div');
               div.innerText = text;
+              if (isBusyUpdate) div.dataset.busy = '1';
               div.style.borderBottom = "1px solid #111"; 
               div.style.padding = "2px 0";
               el.appendChild(div);
@@ -422,7 +473,7 @@ function disassembleBlock(startAddr, bytes) {
       // 1. Small Log (Flasher Tab) - FIX: Hide Debug Info
       // We only show the message here if it does NOT start with "DBG:"
       if (!msg.startsWith("DBG:")) {
-          appendLine('log', `[${timeSimple}] ${msg}`, msg.includes("BUSY"));
+          appendLine('log', `[${timeSimple}] ${msg}`, !!isBusy);
       }
 
       // 2. Large Log (Console Tab) - Here we show EVERYTHING
@@ -483,44 +534,12 @@ function disassembleBlock(startAddr, bytes) {
 
   function cmd(action) { toggleAllButtons(true); log("CMD: " + action); fetch('/api/' + action).then(r=>r.text()).then(txt=>{ log("RES: " + txt); toggleAllButtons(false); }).catch(e=>{ log("Err: "+e); toggleAllButtons(false); }); }
 
-  function autoConnect() { fetch('/api/init').then(r=>r.text()).then(txt => { getChipInfo(); }).catch(e => log("Auto-Connect: No response.")); }
-
   function getChipInfo() {
     toggleAllButtons(true); 
     document.getElementById('infoTableContainer').innerHTML = "<p style='color:#888'>Reading Chip...</p>";
     document.getElementById('hexPreview').style.display = 'none';
     
-    fetch('/api/info').then(r=>r.json()).then(data => {
-        let lockCol = data.locked ? "#ff1744" : "#00c853";
-        let statusText = data.locked ? "LOCKED" : "Verbunden";
-        let badge = document.getElementById('connStatus');
-        if(badge) { badge.innerText = statusText; badge.style.background = lockCol; }
-
-        let html = `<table>
-            <tr><th>Status</th><td style="color:${lockCol}"><b>${statusText}</b></td></tr>
-            <tr><th>Model</th><td><b>${data.model}</b></td></tr>
-            <tr><th>Rev</th><td>${data.rev}</td></tr>
-            <tr><th>Flash</th><td>${data.flash}</td></tr>
-            <tr><th>MAC</th><td>${data.mac}</td></tr>
-            </table>`;
-        document.getElementById('infoTableContainer').innerHTML = html;
-        
-        if(data.preview && data.preview !== "LOCKED") {
-            let raw = data.preview.trim().split(" ");
-            let formatted = "<div style='color:#00e676; margin-bottom:5px;'>Flash Preview:</div>";
-            for(let i=0; i<raw.length; i+=16) {
-                let addr = (i).toString(16).toUpperCase().padStart(4, '0');
-                formatted += `<span class="hex-addr">${addr}:</span>${raw.slice(i, i+16).join(" ")}\n`;
-            }
-            let hp = document.getElementById('hexPreview'); hp.innerHTML = formatted; hp.style.display = 'block';
-        }
-        
-        toggleAllButtons(false);
-        if(data.locked) {
-             ['btnFlash','btnVerify','btnDump'].forEach(id => { let b=document.getElementById(id); if(b) b.disabled=true; });
-             log("INFO: Chip is LOCKED.");
-        }
-    }).catch(e=>{ 
+    fetch('/api/info').then(r=>r.json()).then(showChipInfo).catch(e=>{ 
         document.getElementById('infoTableContainer').innerHTML = "<p style='color:#ff5252'>Keine Antwort.</p>";
         
         // set Header status to OFFLINE
@@ -534,11 +553,52 @@ function disassembleBlock(startAddr, bytes) {
     });
   }
 
+  function showChipInfo(data) {
+    let lockCol = data.locked ? "#ff1744" : "#00c853";
+    let statusText = data.locked ? "LOCKED" : "Verbunden";
+    let badge = document.getElementById('connStatus');
+    if(badge) { badge.innerText = statusText; badge.style.background = lockCol; }
+
+    let html = `<table>
+        <tr><th>Status</th><td style="color:${lockCol}"><b>${statusText}</b></td></tr>
+        <tr><th>Model</th><td><b>${data.model}</b></td></tr>
+        <tr><th>Rev</th><td>${data.rev}</td></tr>
+        <tr><th>Flash</th><td>${data.flash}</td></tr>
+        <tr><th>MAC</th><td>${data.mac}</td></tr>
+        </table>`;
+    document.getElementById('infoTableContainer').innerHTML = html;
+    
+    if(data.preview && data.preview !== "LOCKED") {
+        let raw = data.preview.trim().split(" ");
+        let formatted = "<div style='color:#00e676; margin-bottom:5px;'>Flash Preview:</div>";
+        for(let i=0; i<raw.length; i+=16) {
+            let addr = (i).toString(16).toUpperCase().padStart(4, '0');
+            formatted += `<span class="hex-addr">${addr}:</span>${raw.slice(i, i+16).join(" ")}\n`;
+        }
+        let hp = document.getElementById('hexPreview'); hp.innerHTML = formatted; hp.style.display = 'block';
+    }
+    
+    toggleAllButtons(false);
+    if(data.locked) {
+         ['btnFlash','btnVerify','btnDump'].forEach(id => { let b=document.getElementById(id); if(b) b.disabled=true; });
+         log("INFO: Chip is LOCKED.");
+    }
+  }
+
+  // start/length query of a range row (empty fields = whole flash / image)
+  function rangeQuery(startId, lenId) {
+    let q = [];
+    let s = document.getElementById(startId).value.trim(), l = document.getElementById(lenId).value.trim();
+    if(s) q.push('start=0x' + s.replace(/^0x/i, ''));
+    if(l) q.push('length=0x' + l.replace(/^0x/i, ''));
+    return q.length ? '?' + q.join('&') : '';
+  }
+
   function dumpFirmware() {
     log("Starting Dump..."); toggleAllButtons(true);
     document.getElementById('dumpProgCont').style.display = 'block'; 
     document.getElementById('dumpProgBar').style.width = '0%';
-    fetch('/api/start_dump').then(r=>r.text()).then(t => { log(t); lastLogMsg = ""; pollStatus('DUMP'); }).catch(e=>{ log("Err: "+e); resetUI(); });
+    fetch('/api/start_dump' + rangeQuery('dumpStart', 'dumpLen')).then(r=>r.text()).then(t => { log(t); lastLogMsg = ""; watchStatus('DUMP'); }).catch(e=>{ log("Err: "+e); resetUI(); });
   }
 
   function lockChip() {
@@ -558,50 +618,95 @@ function disassembleBlock(startAddr, bytes) {
   function triggerUpload(action) { currentAction = action; document.getElementById('hiddenFileInput').click(); }
   function onFileSelected(input) { if (input.files && input.files[0]) startUploadProcess(input.files[0]); input.value = ''; }
 
-  function startUploadProcess(file) {
-    let fd = new FormData(); fd.append("file", file);
+  // gzip in the browser (the ESP inflates while receiving), unless it does not pay off
+  async function gzipFile(file) {
+    if(!window.CompressionStream || /\.gz$/i.test(file.name)) return file;
+    try {
+      let blob = await new Response(file.stream().pipeThrough(new CompressionStream('gzip'))).blob();
+      return (blob.size < file.size) ? new File([blob], file.name + '.gz') : file;
+    } catch(e) { return file; }
+  }
+
+  async function startUploadProcess(file) {
     toggleAllButtons(true);
+    let upload = await gzipFile(file);
+    let fd = new FormData(); fd.append("file", upload);
     let fpc = document.getElementById('flashProgCont'); fpc.style.display = 'block';
     let fpb = document.getElementById('flashProgBar'); fpb.style.width = '0%'; fpb.style.backgroundColor = '#00c853';
     document.getElementById('flashStatusText').style.display = 'block';
     document.getElementById('flashStatusText').innerText = t('stat_upload');
     
-    log(`Upload: ${file.name}`);
+    log(`Upload: ${file.name}` + (upload !== file ? ` (gzip ${file.size} -> ${upload.size} B)` : ''));
     let xhr = new XMLHttpRequest(); xhr.open("POST", "/upload", true);
     xhr.upload.onprogress = function(e) { if (e.lengthComputable) fpb.style.width = ((e.loaded / e.total) * 100) + '%'; };
     xhr.onload = function() {
       if (xhr.status === 200) {
         fpb.style.width = '0%'; fpb.style.backgroundColor = '#29b6f6';
         let api = (currentAction === 'FLASH') ? '/api/start_flash' : '/api/start_verify';
-        fetch(api).then(r => r.text()).then(t => { log(t); lastLogMsg = ""; pollStatus('FLASH'); });
-      } else { log("Upload Failed"); resetUI(); }
+        let q = rangeQuery('fwStart', 'fwLen');
+        let keep = document.getElementById('fwPreserve').value.replace(/\s/g, '');
+        if(keep) q += (q ? '&' : '?') + 'preserve=' + encodeURIComponent(keep);
+        fetch(api + q).then(r => r.text()).then(t => { log(t); lastLogMsg = ""; watchStatus('FLASH'); });
+      } else { log("Upload Failed" + (xhr.status === 409 ? ": BUSY" : "")); resetUI(); }
     };
     xhr.send(fd);
   }
 
-  function pollStatus(mode) {
-    let iv = setInterval(() => {
-        fetch('/api/status').then(r => r.json()).then(d => {
-            let dpb = document.getElementById('dumpProgBar');
-            let fpb = document.getElementById('flashProgBar');
-            let fst = document.getElementById('flashStatusText');
-            if(mode === 'DUMP' && dpb) dpb.style.width = d.pct + '%';
-            else { 
-                if(fpb) fpb.style.width = d.pct + '%'; 
-                if(fst) fst.innerText = d.msg + " (" + d.pct + "%)";
-            }
-            if(d.msg !== lastLogMsg) { lastLogMsg = d.msg; if(d.msg && d.msg !== "System bereit.") log(d.msg); }
-            if(d.msg === "DUMP_READY") {
-                clearInterval(iv); log("Download started..."); window.location.href = "/download/dump.bin"; setTimeout(resetUI, 2000);
-            } 
-            else if(!d.msg.startsWith("BUSY")) {
-                clearInterval(iv);
-                if(d.msg.includes("Erfolg") && mode !== 'DUMP') { if(fpb) { fpb.style.width = '100%'; fpb.style.backgroundColor = '#00c853'; } }
-                else if (d.msg.includes("Error") || d.msg.includes("Mismatch")) { if(fpb) fpb.style.backgroundColor = '#ff1744'; }
-                setTimeout(resetUI, 2000);
-            }
-        }).catch(e => { clearInterval(iv); resetUI(); });
-    }, 250);
+  // Interrupted Flash job: continue from the last checkpoint (no new upload, no chip erase)
+  function resumeFlash() {
+    toggleAllButtons(true);
+    document.getElementById('flashProgCont').style.display = 'block';
+    let fpb = document.getElementById('flashProgBar'); fpb.style.width = '0%'; fpb.style.backgroundColor = '#29b6f6';
+    document.getElementById('flashStatusText').style.display = 'block';
+    log("CMD: resume_flash");
+    fetch('/api/resume_flash').then(r => r.text()).then(t => { log(t); lastLogMsg = ""; watchStatus('FLASH'); }).catch(e => { log("Err: " + e); resetUI(); });
+  }
+
+  function showResume(on) { let b = document.getElementById('btnResume'); if(b) b.style.display = on ? 'block' : 'none'; }
+
+  // --- PUSH EVENTS ---
+  // One persistent subscription replaces the status polling. The server sends
+  // the current status on (re-)connect, so no update is lost.
+  function connectEvents() {
+    if(evtSrc || !window.EventSource) return;
+    evtSrc = new EventSource('/api/events');
+    evtSrc.addEventListener('status', e => onStatus(JSON.parse(e.data)));
+    evtSrc.addEventListener('debug', e => { if(!dbgReady()) showCpuState(JSON.parse(e.data)); });
+    evtSrc.addEventListener('watch', e => onWatchSamples(JSON.parse(e.data)));
+  }
+
+  function watchStatus(mode) {
+    statusMode = mode;
+    watchT0 = lastJobT0;
+    if(!evtSrc || evtSrc.readyState !== EventSource.OPEN) fetch('/api/status').then(r => r.json()).then(onStatus).catch(e => {});
+  }
+
+  function onStatus(d) {
+    showResume(d.resume);
+    lastJobT0 = d.t0;
+    if(!statusMode) return;
+    // Result of the previous job, the new one has not started yet
+    if(d.t0 === watchT0 && d.code !== ST_BUSY) return;
+    let mode = statusMode;
+    let msg = statusText(d);
+    let dpb = document.getElementById('dumpProgBar');
+    let fpb = document.getElementById('flashProgBar');
+    let fst = document.getElementById('flashStatusText');
+    if(mode === 'DUMP' && dpb) dpb.style.width = d.pct + '%';
+    else { 
+        if(fpb) fpb.style.width = d.pct + '%'; 
+        if(fst) fst.innerText = msg + " (" + d.pct + "%)";
+    }
+    if(msg !== lastLogMsg) { lastLogMsg = msg; if(d.code !== ST_READY) log(msg, d.code === ST_BUSY); }
+    if(d.code === ST_DUMP_READY) {
+        statusMode = null; log("Download started..."); window.location.href = "/download/dump.bin"; setTimeout(resetUI, 2000);
+    } 
+    else if(d.code !== ST_BUSY) {
+        statusMode = null;
+        if(d.code < ERR_FIRST && mode !== 'DUMP') { if(fpb) { fpb.style.width = '100%'; fpb.style.backgroundColor = '#00c853'; } }
+        else if (d.code >= ERR_FIRST) { if(fpb) fpb.style.backgroundColor = '#ff1744'; }
+        setTimeout(resetUI, 2000);
+    }
   }
 
   function resetUI() {
@@ -611,60 +716,139 @@ function disassembleBlock(startAddr, bytes) {
     document.getElementById('dumpProgCont').style.display = 'none';
   }
 
-  function startDebugPoll() { refreshDebug(); if(!debugTimer) debugTimer = setInterval(refreshDebug, 1500); }
-  function stopDebugPoll() { if(debugTimer) { clearInterval(debugTimer); debugTimer = null; } }
-  function debugCmd(c) { fetch('/api/debug/'+c).then(r=>r.text()).then(t=>{log("DBG: "+t); setTimeout(refreshDebug, 400); }); }
+  // --- Debugger-Kanal: binäres WebSocket-Protokoll (/ws/debug, siehe debug_channel.h) ---
+  // Anfragen laufen ohne Warten hintereinander (Pipelining), die ID ordnet die Antworten zu.
+  // Ohne WebSocket bleibt alles bei den HTTP-Endpunkten.
+  const DBG = { STATUS: 1, HALT: 2, RESUME: 3, STEP: 4, REGS: 5, READ: 6, WRITE: 7, BP_SET: 8, BP_CLEAR: 9,
+                STEP_OVER: 10, STEP_OUT: 11, RUN_TO: 12, BP_LIST: 13, EVT_STATE: 0x80 };
+  const DBG_RESULT = ['OK', 'BUSY', 'BAD REQUEST', 'UNKNOWN OP', 'NOT HALTED', 'NO RETURN ADDRESS', 'BP FULL', 'BAD CONDITION'];
+  let dbgWs = null, dbgSeq = 0;
+  const dbgPending = new Map();
+
+  function openDebugWs() {
+    if(dbgWs || !window.WebSocket) return;
+    dbgWs = new WebSocket(`ws://${location.host}/ws/debug`);
+    dbgWs.binaryType = 'arraybuffer';
+    dbgWs.onmessage = e => {
+      let b = new Uint8Array(e.data);
+      if(b[0] === DBG.EVT_STATE) { showCpuState(snapshotRegs(b.subarray(3))); return; } // Push der Halt-Überwachung
+      let p = dbgPending.get(b[1]);
+      if(!p) return;
+      dbgPending.delete(b[1]);
+      if(b[2] === 0) p.resolve(b.subarray(3)); else p.reject(new Error(DBG_RESULT[b[2]] || 'ERROR'));
+    };
+    dbgWs.onclose = () => {
+      dbgWs = null;
+      dbgPending.forEach(p => p.reject(new Error('closed')));
+      dbgPending.clear();
+    };
+  }
+  function dbgReady() { return dbgWs && dbgWs.readyState === WebSocket.OPEN; }
+
+  function dbgCall(op, payload = []) {
+    return new Promise((resolve, reject) => {
+      if(!dbgReady()) { reject(new Error('offline')); return; }
+      dbgSeq = (dbgSeq + 1) & 0xFF;
+      dbgPending.set(dbgSeq, { resolve, reject });
+      dbgWs.send(new Uint8Array([op, dbgSeq, ...payload]));
+    });
+  }
+
+  // Snapshot [status][PC][ACC B PSW SP DPL DPH P0 P1 P2][R0..R7] -> Objekt wie /api/debug/registers
+  function snapshotRegs(b) {
+    const hx = v => '0x' + v.toString(16);
+    let regs = { halted: !!(b[0] & 0x20) && b[0] !== 0xFF, raw: hx(b[0]) };
+    if(b.length < 20) return regs;
+    regs.PC = hx(b[1] | (b[2] << 8));
+    ['ACC', 'B', 'PSW', 'SP', 'DPL', 'DPH', 'P0', 'P1', 'P2'].forEach((n, i) => regs[n] = hx(b[3 + i]));
+    regs.DPTR = hx((b[8] << 8) | b[7]);
+    regs.R = Array.from(b.subarray(12, 20), hx);
+    return regs;
+  }
+
+  // Solange der Socket offen ist, meldet der ESP Zustandswechsel selbst (Halt-Überwachung):
+  // der Timer pollt dann nicht, er verbindet nur bei Abbruch neu
+  function startDebugPoll() { openDebugWs(); refreshDebug(); loadBpList(); if(!debugTimer) debugTimer = setInterval(() => refreshDebug(true), 1500); }
+  function stopDebugPoll() {
+      if(debugTimer) { clearInterval(debugTimer); debugTimer = null; }
+      if(dbgWs) dbgWs.close(); // Ohne Debugger-Client pausiert die Überwachung
+  }
+  function debugCmd(c) {
+      const op = { halt: DBG.HALT, resume: DBG.RESUME, step: DBG.STEP, step_over: DBG.STEP_OVER, step_out: DBG.STEP_OUT }[c];
+      if(op && dbgReady()) {
+          // Antwort enthält schon Status + Register: kein Nachladen nötig
+          dbgCall(op).then(b => { log("DBG: " + c.toUpperCase()); showCpuState(snapshotRegs(b)); }).catch(e => log("DBG: " + e.message));
+          return;
+      }
+      fetch('/api/debug/'+c).then(r=>r.text()).then(t=>{log("DBG: "+t); if(!evtSrc) setTimeout(refreshDebug, 400); });
+  }
   
-  function refreshDebug() {
-      fetch('/api/debug/status').then(r=>r.json()).then(s => {
-          let badge = document.getElementById('cpuStateBadge');
-          if(badge) {
-            if(s.halted) { badge.innerText = "HALTED"; badge.className = "status-badge halt"; loadRegisters(); } 
-            else { badge.innerText = "RUNNING"; badge.className = "status-badge run"; }
-          }
-      }).catch(e=>{});
+  function refreshDebug(timer) {
+      openDebugWs(); // Wiederverbinden nach Abbruch
+      if(timer && dbgReady()) return;
+      if(dbgReady()) { dbgCall(DBG.REGS).then(b => showCpuState(snapshotRegs(b))).catch(e=>{}); return; }
+      fetch('/api/debug/status').then(r=>r.json()).then(showCpuState).catch(e=>{});
+  }
+
+  // s.R vorhanden = Register sind schon dabei (Snapshot), sonst nachladen
+  function showCpuState(s) {
+      let badge = document.getElementById('cpuStateBadge');
+      if(badge) {
+        if(s.halted) { badge.innerText = "HALTED"; badge.className = "status-badge halt"; if(s.R) showRegisters(s); else loadRegisters(); } 
+        else { badge.innerText = "RUNNING"; badge.className = "status-badge run"; }
+      }
   }
 
   function loadRegisters() {
-      fetch('/api/debug/registers').then(r=>r.json()).then(regs => {
-          // DPTR Berechnung (wie gehabt)
-          let dptrVal = 0;
-          // Fallback falls DPTR als String kommt oder aus DPH/DPL zusammengesetzt werden muss
-          if(regs.DPTR) dptrVal = parseInt(regs.DPTR, 16);
-          
-          // Helper zum Setzen der Werte
-          const setR = (id, val) => { 
-              let el = document.getElementById('r_'+id); 
-              if(el && val) el.innerText = val; 
-          };
-
-          // NEU: PC setzen
-          setR('PC', regs.PC);
-
-          // Standard Register
-          setR('ACC', regs.ACC); 
-          setR('B', regs.B); 
-          setR('PSW', regs.PSW); 
-          setR('SP', regs.SP);
-          
-          // GPIOs
-          setR('P0', regs.P0); 
-          setR('P1', regs.P1); 
-          setR('P2', regs.P2);
-          
-          // DPH / DPL einzeln (falls im JSON) oder berechnet
-          if(regs.DPH) setR('DPH', regs.DPH);
-          if(regs.DPL) setR('DPL', regs.DPL);
-
-          // NEU: R0-R7 Array verarbeiten
-          if(regs.R && Array.isArray(regs.R)) {
-              for(let i=0; i<8; i++) {
-                  setR('R'+i, regs.R[i]);
-              }
+      if(dbgReady()) { dbgCall(DBG.REGS).then(b => showRegisters(snapshotRegs(b))).catch(e=>{ console.log("Reg Error", e); }); return; }
+      fetch('/api/debug/registers').then(r=>r.json()).then(showRegisters).catch(e=>{ console.log("Reg Error", e); });
+  }
+
+  function showRegisters(regs) {
+      // DPTR Berechnung (wie gehabt)
+      let dptrVal = 0;
+      // Fallback falls DPTR als String kommt oder aus DPH/DPL zusammengesetzt werden muss
+      if(regs.DPTR) dptrVal = parseInt(regs.DPTR, 16);
+      
+      // Helper zum Setzen der Werte
+      const setR = (id, val) => { 
+          let el = document.getElementById('r_'+id); 
+          if(el && val) el.innerText = val; 
+      };
+
+      // NEU: PC setzen
+      setR('PC', regs.PC);
+
+      // Standard Register
+      setR('ACC', regs.ACC); 
+      setR('B', regs.B); 
+      setR('PSW', regs.PSW); 
+      setR('SP', regs.SP);
+      
+      // GPIOs
+      setR('P0', regs.P0); 
+      setR('P1', regs.P1); 
+      setR('P2', regs.P2);
+      
+      // DPH / DPL einzeln (falls im JSON) oder berechnet
+      if(regs.DPH) setR('DPH', regs.DPH);
+      if(regs.DPL) setR('DPL', regs.DPL);
+
+      // NEU: R0-R7 Array verarbeiten
+      if(regs.R && Array.isArray(regs.R)) {
+          for(let i=0; i<8; i++) {
+              setR('R'+i, regs.R[i]);
           }
-      }).catch(e=>{ console.log("Reg Error", e); });
+      }
   }
   
+  // Run to Cursor: Hardware-Breakpoint auf der Zeile, ein Resume (läuft die CPU danach noch, meldet die Halt-Überwachung den Treffer)
+  function runTo(addrStr) {
+      let a = parseInt(addrStr, 16);
+      if(dbgReady()) { dbgCall(DBG.RUN_TO, [a & 0xFF, (a >> 8) & 0xFF]).then(b => { log("DBG: RUN TO " + addrStr); showCpuState(snapshotRegs(b)); }).catch(e => log("DBG: " + e.message)); return; }
+      debugCmd('run_to?addr=' + addrStr);
+  }
+
   function jumpTo(addrStr) {
     document.getElementById('memAddr').value = addrStr;
     loadMem();
@@ -674,16 +858,18 @@ function disassembleBlock(startAddr, bytes) {
       let addr = document.getElementById('memAddr').value; let len = document.getElementById('memLen').value;
       // FIX: Use translation for loading message
       document.getElementById('hexView').innerHTML = "<div style='text-align:center; color:#666;'>" + t('msg_loading') + "</div>";
-      fetch(`/api/debug/mem?addr=${addr}&len=${len}`).then(r=>r.text()).then(hex => { renderHex(addr, hex); });
+      let space = document.getElementById('memSpace').value;
+      fetch(`/api/debug/mem.bin?space=${space}&addr=${addr}&len=${len}`)
+        .then(r => { if(!r.ok) return r.text().then(msg => { throw new Error(msg); }); return r.arrayBuffer(); })
+        .then(buf => { renderHex(addr, buf); })
+        .catch(e => { document.getElementById('hexView').innerHTML = "<div style='text-align:center; color:#e57373;'>" + e.message + "</div>"; });
   }
   
-  function renderHex(startAddrStr, hexStr) {
-    // 1. Hex-String in Byte-Array wandeln
-    let bytes = [];
-    for(let i=0; i<hexStr.length; i+=2) {
-        bytes.push(parseInt(hexStr.substr(i, 2), 16));
-    }
+  function renderHex(startAddrStr, buf) {
+    // 1. Rohdaten (ArrayBuffer) als Byte-Array
+    let bytes = Array.from(new Uint8Array(buf));
     let startAddr = parseInt(startAddrStr, 16);
+    if(document.getElementById('memSpace').value === 'sfr' && startAddr < 0x80) startAddr = 0x80; // Server klemmt ebenso
 
     // Aktuellen PC holen (für Highlighting)
     let currentPC = -1;
@@ -728,7 +914,7 @@ function disassembleBlock(startAddr, bytes) {
             // -----------------------------------------------------------
 
             html += `<div class="hv-row" style="${style}">
-                <span style="color:#888; margin-right:5px; user-select:none;">${marker}</span>
+                <span style="color:#888; margin-right:5px; user-select:none; cursor:pointer;" title="Run to" onclick="runTo('${line.addrStr}')">${marker}</span>
                 <span class="hv-addr" style="width:60px; display:inline-block; ${line.addr === currentPC ? 'color:#fff' : ''}">${line.addrStr}:</span>
                 <span class="hv-bytes" style="color:#aaa; width:100px; display:inline-block;">${line.hex}</span>
                 <!-- Hier nutzen wir jetzt asmFormatted statt line.asm -->
@@ -739,18 +925,112 @@ function disassembleBlock(startAddr, bytes) {
     
     document.getElementById('hexView').innerHTML = html;
   }
+  // Breakpoints: bis zu 4 Hardware-Comparatoren, Liste aus dem Cache des ESP.
+  // Adresse bis FFFF = PC in der eingeblendeten Bank, darüber flach (Bank * 32 KB + Offset)
+  function bpPayload(a) {
+      if(a > 0xFFFF) return [a & 0xFF, ((a >> 8) & 0x7F) | 0x80, a >> 15];
+      return [a & 0xFF, (a >> 8) & 0xFF];
+  }
+
+  // Bedingung (optional) wird auf dem ESP bei jedem Treffer ausgewertet, z.B. "x16:F000 == 1000 && hits > 3"
   function setBp() {
       let addr = document.getElementById('bpAddr').value;
+      let cond = document.getElementById('bpCond').value.trim();
       if(!addr) return;
-      debugCmd('bp?addr=' + addr);
-      // Visuelles Feedback
-      document.getElementById('bpAddr').style.background = '#3a1c1c'; // Dunkelrot hinterlegen
+      if(dbgReady()) {
+          let p = bpPayload(parseInt(addr, 16));
+          if(cond) { if(p.length < 3) p.push(0xFF); for(const c of cond) p.push(c.charCodeAt(0) & 0x7F); }
+          dbgCall(DBG.BP_SET, p).then(b => { log("DBG: BP" + b[0] + " SET @ " + addr + (cond ? " IF " + cond : "")); loadBpList(); })
+              .catch(e => log("DBG: " + e.message));
+      }
+      else fetch('/api/debug/bp?addr=' + addr + (cond ? '&cond=' + encodeURIComponent(cond) : '')).then(r => r.text()).then(t => { log("DBG: " + t); loadBpList(); });
+      document.getElementById('bpAddr').value = '';
   }
 
-  function clearBp() {
-      debugCmd('bp?addr=off');
+  // Mit Adresse im Feld nur diesen Breakpoint, sonst alle
+  function clearBp(addr) {
+      addr = addr || document.getElementById('bpAddr').value;
+      let a = parseInt(addr, 16);
+      if(dbgReady()) dbgCall(DBG.BP_CLEAR, addr ? bpPayload(a) : []).then(() => { log("DBG: BP CLEARED" + (addr ? " @ " + addr : "")); loadBpList(); }).catch(e => log("DBG: " + e.message));
+      else fetch('/api/debug/bp?' + (addr ? 'clear=' + addr : 'addr=off')).then(r => r.text()).then(t => { log("DBG: " + t); loadBpList(); });
       document.getElementById('bpAddr').value = '';
-      document.getElementById('bpAddr').style.background = '#111'; // Reset
+  }
+
+  // Liste kommt aus dem Cache auf dem ESP (kein Link-Zugriff), mit Bedingung und Zaehlern
+  function loadBpList() {
+      const hex = v => v.toString(16).toUpperCase().padStart(4, '0');
+      fetch('/api/debug/bp').then(r => r.json()).then(j => {
+          // Bank-Adressen (>64 KB) als flache Adresse, Klick entfernt den Breakpoint
+          document.getElementById('bpList').innerHTML = j.bp.map(bp => {
+              let addr = hex(parseInt(bp.flat, 16));
+              let title = `BP${bp.n} - click to clear`;
+              if(bp.cond) title += `\nIF ${bp.cond}\nhits ${bp.hits}, stops ${bp.stops}, auto-resumes ${bp.resumes}\nresume latency avg ${bp.avg_us} us, max ${bp.max_us} us`;
+              return `<span style="cursor:pointer; margin-right:6px;" title="${title}" onclick="clearBp('${addr}')">${addr}${bp.cond ? '?' + bp.hits : ''}</span>`;
+          }).join('');
+      }).catch(e => {});
+  }
+
+  // --- LIVE WATCH ---
+  // Der ESP hält die CPU je Sample kurz an, liest alle Variablen und lässt sie weiterlaufen.
+  // Samples kommen als SSE "watch"-Events: [ms, Haltezeit us, Wert...]
+  const WATCH_POINTS = 300;
+  const WATCH_COLORS = ['#ff4081', '#4caf50', '#2196f3', '#ffc107', '#9c27b0', '#00bcd4', '#ff5722', '#cddc39'];
+  let watchVars = [], watchData = [];
+
+  function varWatchStart() {
+      let vars = document.getElementById('watchVars').value.replace(/\s/g, '');
+      let hz = document.getElementById('watchHz').value;
+      fetch('/api/watch/start?vars=' + encodeURIComponent(vars) + '&hz=' + hz + '&ms=3600000').then(r => r.text()).then(t => {
+          log("WATCH: " + t);
+          if(t !== 'Watch Start') return;
+          watchVars = vars.split(',');
+          watchData = [];
+          connectEvents();
+      });
+  }
+
+  function varWatchStop() {
+      fetch('/api/watch/stop').then(r => r.text()).then(() => setTimeout(loadWatchInfo, 300));
+  }
+
+  // Endstand mit Haltezeit-Statistik des ganzen Laufs (die Events tragen nur die letzten Samples)
+  function loadWatchInfo() {
+      fetch('/api/watch').then(r => r.json()).then(j => {
+          watchVars = j.vars ? j.vars.replace(/\s/g, '').split(',') : [];
+          document.getElementById('watchInfo').innerText = `${j.state}, ${j.samples} samples, halt ${j.halt_us.last}/${j.halt_us.avg}/${j.halt_us.max} us (last/avg/max)`;
+          if(!j.running) log(`WATCH: ${j.state}, ${j.samples} samples, halt avg ${j.halt_us.avg} us, max ${j.halt_us.max} us`);
+      }).catch(e => {});
+  }
+
+  function onWatchSamples(j) {
+      if(!watchVars.length) loadWatchInfo(); // Von einem anderen Tab gestartet
+      watchData.push(...j.s);
+      if(watchData.length > WATCH_POINTS) watchData.splice(0, watchData.length - WATCH_POINTS);
+      drawWatch();
+  }
+
+  function drawWatch() {
+      const c = document.getElementById('watchChart');
+      if(!c || !c.clientWidth || !watchData.length) return;
+      c.width = c.clientWidth;
+      const g = c.getContext('2d'), w = c.width, h = c.height;
+      g.clearRect(0, 0, w, h);
+      g.font = '10px monospace';
+      // Jede Variable auf ihren eigenen Wertebereich skaliert
+      watchVars.forEach((name, i) => {
+          const vals = watchData.map(s => s[2 + i]);
+          const lo = Math.min(...vals), hi = Math.max(...vals), span = (hi - lo) || 1;
+          g.strokeStyle = g.fillStyle = WATCH_COLORS[i % WATCH_COLORS.length];
+          g.beginPath();
+          vals.forEach((v, k) => {
+              const x = k * w / (WATCH_POINTS - 1), y = h - 4 - (v - lo) * (h - 8) / span;
+              if(k) g.lineTo(x, y); else g.moveTo(x, y);
+          });
+          g.stroke();
+          g.fillText(`${name} = ${vals[vals.length - 1]}  [${lo}..${hi}]`, 4, 12 + i * 11);
+      });
+      const us = watchData.map(s => s[1]);
+      document.getElementById('watchInfo').innerText = `${watchData[watchData.length - 1][0]} ms, halt ${us[us.length - 1]} us (max ${Math.max(...us)} us)`;
   }
 
   function toggleViewMode() {
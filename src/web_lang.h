@@ -33,15 +33,56 @@ const char languages_json[] PROGMEM = R"rawliteral(
     "msg_erase_warn": "ACHTUNG: Chip wirklich komplett löschen?\n\nAlle Daten gehen verloren! Locked-Chips werden entsperrt.",
     "sec_registers": "Register",
     "sec_gpio": "GPIO Ports",
+    "sec_watch": "Live-Variablen",
     "sec_xdata": "XDATA SPEICHER",
     "btn_halt": "HALT (Pause)",
     "btn_resume": "RUN (Start)",
     "btn_step": "STEP (Schritt)",
+    "btn_step_over": "ÜBERSPRINGEN (Over)",
+    "btn_step_out": "VERLASSEN (Out)",
     "btn_refresh": "Aktualisieren",
     "lbl_len": "Länge:",
     "btn_go": "LOS",
     "msg_wait_debug": "Warte auf Debug-Daten...",
-    "msg_loading": "Lade Daten..."
+    "msg_loading": "Lade Daten...",
+    "btn_resume_flash": "Flashen fortsetzen",
+    "ph_idle": "Bereit",
+    "ph_init": "Debug-Modus initialisieren",
+    "ph_detect": "Chip erkennen",
+    "ph_prepare": "Vorbereitung",
+    "ph_erase": "Chip wird gelöscht",
+    "ph_read": "Flash lesen",
+    "ph_write": "Schreiben",
+    "ph_verify": "Verifizieren",
+    "ph_resume": "Fortsetzen",
+    "ph_lock": "Lock-Bits setzen",
+    "st_ready": "System bereit.",
+    "st_dump_ready": "Dump fertig.",
+    "st_flash_ok": "Erfolg: Flash & Verify OK!",
+    "st_verify_ok": "Erfolg: Chip identisch!",
+    "st_erase_ok": "Erfolg: Chip gelöscht & entsperrt!",
+    "st_lock_ok": "Erfolg: Chip gesperrt (Lesegeschützt)!",
+    "err_no_response": "Fehler: Chip antwortet nicht",
+    "err_fs_write": "Fehler: Dateisystem-Schreibfehler",
+    "err_file_missing": "Fehler: Datei fehlt!",
+    "err_no_checkpoint": "Fehler: Kein gültiger Checkpoint!",
+    "err_erase": "Fehler: Löschen fehlgeschlagen!",
+    "err_erase_page": "Fehler: Löschen fehlgeschlagen @ {addr}",
+    "err_write": "Fehler: Schreibfehler @ {addr} (fortsetzbar)",
+    "err_mismatch": "Fehler: Abweichung @ {addr} (Soll:{exp} Ist:{act})",
+    "err_verify": "Fehler: Verifikation fehlgeschlagen @ {addr}",
+    "err_unknown": "Fehler: Unbekannter Status",
+    "err_link": "Fehler: Debug-Verbindung gestört @ {addr} (Prüfsumme falsch)",
+    "link_retries": "{n} Wiederholungen, Takt {clk} µs",
+    "ph_repair": "Seite neu programmieren",
+    "page_repairs": "{n} Seiten repariert",
+    "lbl_range": "Bereich",
+    "lbl_range_fw": "Ab Adresse",
+    "ph_range_all": "alles",
+    "err_range": "Fehler: Bereich ungültig @ {addr} (außerhalb des Flash oder nicht am Seitenanfang)",
+    "lbl_preserve": "Erhalten",
+    "ph_preserve": "Geschützte Bereiche sichern",
+    "err_preserve": "Fehler: Geschützte Bereiche zu groß (max. 16 KB) oder kein Speicher"
   },
   "en": {
     "title": "TI CC Flasher",
@@ -73,15 +114,56 @@ const char languages_json[] PROGMEM = R"rawliteral(
     "msg_erase_warn": "WARNING: Erase entire Chip?\n\nAll data will be lost! Locked chips will be unlocked.",
     "sec_registers": "Registers",
     "sec_gpio": "GPIO Ports",
+    "sec_watch": "Live Watch",
     "sec_xdata": "XDATA MEMORY",
     "btn_halt": "HALT (Pause)",
     "btn_resume": "RUN (Resume)",
     "btn_step": "STEP (Into)",
+    "btn_step_over": "STEP OVER",
+    "btn_step_out": "STEP OUT",
     "btn_refresh": "Refresh",
     "lbl_len": "Len:",
     "btn_go": "GO",
     "msg_wait_debug": "Waiting for debug data...",
-    "msg_loading": "Loading..."
+    "msg_loading": "Loading...",
+    "btn_resume_flash": "Resume Flash",
+    "ph_idle": "Idle",
+    "ph_init": "Init Debug-Mode",
+    "ph_detect": "Detecting Chip",
+    "ph_prepare": "Preparing",
+    "ph_erase": "Erasing Chip",
+    "ph_read": "Reading Flash",
+    "ph_write": "Writing",
+    "ph_verify": "Verifying",
+    "ph_resume": "Resuming",
+    "ph_lock": "Setting Lock-Bits",
+    "st_ready": "System ready.",
+    "st_dump_ready": "Dump ready.",
+    "st_flash_ok": "Success: Flash & Verify OK!",
+    "st_verify_ok": "Success: Chip identical!",
+    "st_erase_ok": "Success: Chip erased & unlocked!",
+    "st_lock_ok": "Success: Chip Locked (Read Protected)!",
+    "err_no_response": "Error: Chip not responding",
+    "err_fs_write": "Error: FS Write Fail",
+    "err_file_missing": "Error: File missing!",
+    "err_no_checkpoint": "Error: No valid checkpoint!",
+    "err_erase": "Error: Erase Fail!",
+    "err_erase_page": "Error: Erase Fail @ {addr}",
+    "err_write": "Error: Write Fail @ {addr} (resumable)",
+    "err_mismatch": "Error: Mismatch @ {addr} (Exp:{exp} Act:{act})",
+    "err_verify": "Error: Verify Fail @ {addr}",
+    "err_unknown": "Error: Unknown status",
+    "err_link": "Error: Debug link corrupted @ {addr} (checksum mismatch)",
+    "link_retries": "{n} retries, clock {clk} µs",
+    "ph_repair": "Reprogramming page",
+    "page_repairs": "{n} pages repaired",
+    "lbl_range": "Range",
+    "lbl_range_fw": "At address",
+    "ph_range_all": "all",
+    "err_range": "Error: Invalid range @ {addr} (outside the flash or not page aligned)",
+    "lbl_preserve": "Preserve",
+    "ph_preserve": "Saving preserved regions",
+    "err_preserve": "Error: Preserved regions too large (max 16 KB) or out of memory"
   },
   "es": {
     "title": "TI CC Flasher",
@@ -113,15 +195,56 @@ const char languages_json[] PROGMEM = R"rawliteral(
     "msg_erase_warn": "¿Borrar todo el chip?\n\n¡Se perderán todos los datos!",
     "sec_registers": "Registros",
     "sec_gpio": "Puertos GPIO",
+    "sec_watch": "Variables en vivo",
     "sec_xdata": "MEMORIA XDATA",
     "btn_halt": "PAUSA (Halt)",
     "btn_resume": "EJECUTAR (Run)",
     "btn_step": "PASO (Step)",
+    "btn_step_over": "SALTAR (Over)",
+    "btn_step_out": "SALIR (Out)",
     "btn_refresh": "Actualizar",
     "lbl_len": "Long:",
     "btn_go": "IR",
     "msg_wait_debug": "Esperando datos de depuración...",
-    "msg_loading": "Cargando..."
+    "msg_loading": "Cargando...",
+    "btn_resume_flash": "Reanudar grabación",
+    "ph_idle": "En espera",
+    "ph_init": "Iniciando modo depuración",
+    "ph_detect": "Detectando chip",
+    "ph_prepare": "Preparando",
+    "ph_erase": "Borrando chip",
+    "ph_read": "Leyendo flash",
+    "ph_write": "Escribiendo",
+    "ph_verify": "Verificando",
+    "ph_resume": "Reanudando",
+    "ph_lock": "Configurando bits de bloqueo",
+    "st_ready": "Sistema listo.",
+    "st_dump_ready": "Volcado listo.",
+    "st_flash_ok": "Éxito: grabación y verificación OK",
+    "st_verify_ok": "Éxito: chip idéntico",
+    "st_erase_ok": "Éxito: chip borrado y desbloqueado",
+    "st_lock_ok": "Éxito: chip bloqueado (protegido)",
+    "err_no_response": "Error: el chip no responde",
+    "err_fs_write": "Error: fallo de escritura en FS",
+    "err_file_missing": "Error: falta el archivo",
+    "err_no_checkpoint": "Error: no hay punto de control válido",
+    "err_erase": "Error: fallo al borrar",
+    "err_erase_page": "Error: fallo al borrar @ {addr}",
+    "err_write": "Error: fallo de escritura @ {addr} (reanudable)",
+    "err_mismatch": "Error: discrepancia @ {addr} (Esp:{exp} Real:{act})",
+    "err_verify": "Error: fallo de verificación @ {addr}",
+    "err_unknown": "Error: estado desconocido",
+    "err_link": "Error: enlace de depuración corrupto @ {addr} (checksum incorrecto)",
+    "link_retries": "{n} reintentos, reloj {clk} µs",
+    "ph_repair": "Reprogramando página",
+    "page_repairs": "{n} páginas reparadas",
+    "lbl_range": "Rango",
+    "lbl_range_fw": "En dirección",
+    "ph_range_all": "todo",
+    "err_range": "Error: rango no válido @ {addr} (fuera de la flash o no alineado a página)",
+    "lbl_preserve": "Conservar",
+    "ph_preserve": "Guardando regiones protegidas",
+    "err_preserve": "Error: regiones protegidas demasiado grandes (máx. 16 KB) o sin memoria"
   },
   "fr": {
     "title": "TI CC Flasher",
@@ -153,15 +276,56 @@ const char languages_json[] PROGMEM = R"rawliteral(
     "msg_erase_warn": "Effacer tout le chip?\n\nToutes les données seront perdues!",
     "sec_registers": "Registres",
     "sec_gpio": "Ports GPIO",
+    "sec_watch": "Variables en direct",
     "sec_xdata": "MÉMOIRE XDATA",
     "btn_halt": "HALTE (Pause)",
     "btn_resume": "LANCER (Run)",
     "btn_step": "PAS (Step)",
+    "btn_step_over": "SAUTER (Over)",
+    "btn_step_out": "SORTIR (Out)",
     "btn_refresh": "Actualiser",
     "lbl_len": "Lon:",
     "btn_go": "GO",
     "msg_wait_debug": "En attente de données...",
-    "msg_loading": "Chargement..."
+    "msg_loading": "Chargement...",
+    "btn_resume_flash": "Reprendre la programmation",
+    "ph_idle": "Inactif",
+    "ph_init": "Init. mode débogage",
+    "ph_detect": "Détection de la puce",
+    "ph_prepare": "Préparation",
+    "ph_erase": "Effacement de la puce",
+    "ph_read": "Lecture de la flash",
+    "ph_write": "Écriture",
+    "ph_verify": "Vérification",
+    "ph_resume": "Reprise",
+    "ph_lock": "Écriture des bits de verrouillage",
+    "st_ready": "Système prêt.",
+    "st_dump_ready": "Dump prêt.",
+    "st_flash_ok": "Succès : programmation et vérification OK !",
+    "st_verify_ok": "Succès : puce identique !",
+    "st_erase_ok": "Succès : puce effacée et déverrouillée !",
+    "st_lock_ok": "Succès : puce verrouillée (protégée en lecture) !",
+    "err_no_response": "Erreur : la puce ne répond pas",
+    "err_fs_write": "Erreur : échec d'écriture FS",
+    "err_file_missing": "Erreur : fichier manquant !",
+    "err_no_checkpoint": "Erreur : aucun point de reprise valide !",
+    "err_erase": "Erreur : échec de l'effacement !",
+    "err_erase_page": "Erreur : échec de l'effacement @ {addr}",
+    "err_write": "Erreur : échec d'écriture @ {addr} (reprise possible)",
+    "err_mismatch": "Erreur : différence @ {addr} (Att:{exp} Lu:{act})",
+    "err_verify": "Erreur : échec de vérification @ {addr}",
+    "err_unknown": "Erreur : état inconnu",
+    "err_link": "Erreur : liaison de débogage perturbée @ {addr} (checksum incorrect)",
+    "link_retries": "{n} reprises, horloge {clk} µs",
+    "ph_repair": "Reprogrammation de la page",
+    "page_repairs": "{n} pages réparées",
+    "lbl_range": "Plage",
+    "lbl_range_fw": "À l'adresse",
+    "ph_range_all": "tout",
+    "err_range": "Erreur : plage invalide @ {addr} (hors de la flash ou non alignée sur une page)",
+    "lbl_preserve": "Conserver",
+    "ph_preserve": "Sauvegarde des zones protégées",
+    "err_preserve": "Erreur : zones protégées trop grandes (max 16 Ko) ou mémoire insuffisante"
   },
   "it": {
     "title": "TI CC Flasher",
@@ -193,15 +357,56 @@ const char languages_json[] PROGMEM = R"rawliteral(
     "msg_erase_warn": "Cancellare l'intero chip?\n\nTutti i dati andranno persi!",
     "sec_registers": "Registri",
     "sec_gpio": "Porte GPIO",
+    "sec_watch": "Variabili live",
     "sec_xdata": "MEMORIA XDATA",
     "btn_halt": "ARRESTA (Halt)",
     "btn_resume": "AVVIA (Run)",
     "btn_step": "PASSO (Step)",
+    "btn_step_over": "SALTA (Over)",
+    "btn_step_out": "ESCI (Out)",
     "btn_refresh": "Aggiorna",
     "lbl_len": "Lun:",
     "btn_go": "VAI",
     "msg_wait_debug": "In attesa di dati...",
-    "msg_loading": "Caricamento..."
+    "msg_loading": "Caricamento...",
+    "btn_resume_flash": "Riprendi flash",
+    "ph_idle": "Inattivo",
+    "ph_init": "Init modalità debug",
+    "ph_detect": "Rilevamento chip",
+    "ph_prepare": "Preparazione",
+    "ph_erase": "Cancellazione chip",
+    "ph_read": "Lettura flash",
+    "ph_write": "Scrittura",
+    "ph_verify": "Verifica",
+    "ph_resume": "Ripresa",
+    "ph_lock": "Impostazione lock-bit",
+    "st_ready": "Sistema pronto.",
+    "st_dump_ready": "Dump pronto.",
+    "st_flash_ok": "Successo: flash e verifica OK!",
+    "st_verify_ok": "Successo: chip identico!",
+    "st_erase_ok": "Successo: chip cancellato e sbloccato!",
+    "st_lock_ok": "Successo: chip bloccato (protetto in lettura)!",
+    "err_no_response": "Errore: il chip non risponde",
+    "err_fs_write": "Errore: scrittura FS fallita",
+    "err_file_missing": "Errore: file mancante!",
+    "err_no_checkpoint": "Errore: nessun checkpoint valido!",
+    "err_erase": "Errore: cancellazione fallita!",
+    "err_erase_page": "Errore: cancellazione fallita @ {addr}",
+    "err_write": "Errore: scrittura fallita @ {addr} (riprendibile)",
+    "err_mismatch": "Errore: discrepanza @ {addr} (Att:{exp} Let:{act})",
+    "err_verify": "Errore: verifica fallita @ {addr}",
+    "err_unknown": "Errore: stato sconosciuto",
+    "err_link": "Errore: collegamento di debug disturbato @ {addr} (checksum errato)",
+    "link_retries": "{n} ripetizioni, clock {clk} µs",
+    "ph_repair": "Riprogrammazione pagina",
+    "page_repairs": "{n} pagine riparate",
+    "lbl_range": "Intervallo",
+    "lbl_range_fw": "All'indirizzo",
+    "ph_range_all": "tutto",
+    "err_range": "Errore: intervallo non valido @ {addr} (fuori dalla flash o non allineato alla pagina)",
+    "lbl_preserve": "Conserva",
+    "ph_preserve": "Salvataggio aree protette",
+    "err_preserve": "Errore: aree protette troppo grandi (max 16 KB) o memoria esaurita"
   },
   "pl": {
     "title": "TI CC Flasher",
@@ -233,15 +438,56 @@ const char languages_json[] PROGMEM = R"rawliteral(
     "msg_erase_warn": "Wyczyścić cały układ?\n\nWszystkie dane zostaną utracone!",
     "sec_registers": "Rejestry",
     "sec_gpio": "Porty GPIO",
+    "sec_watch": "Zmienne na żywo",
     "sec_xdata": "PAMIĘĆ XDATA",
     "btn_halt": "STOP (Halt)",
     "btn_resume": "START (Run)",
     "btn_step": "KROK (Step)",
+    "btn_step_over": "PRZESKOCZ (Over)",
+    "btn_step_out": "WYJDŹ (Out)",
     "btn_refresh": "Odśwież",
     "lbl_len": "Dł:",
     "btn_go": "IDŹ",
     "msg_wait_debug": "Czekam na dane...",
-    "msg_loading": "Ładowanie..."
+    "msg_loading": "Ładowanie...",
+    "btn_resume_flash": "Wznów flashowanie",
+    "ph_idle": "Bezczynny",
+    "ph_init": "Inicjalizacja trybu debug",
+    "ph_detect": "Wykrywanie układu",
+    "ph_prepare": "Przygotowanie",
+    "ph_erase": "Kasowanie układu",
+    "ph_read": "Odczyt flash",
+    "ph_write": "Zapis",
+    "ph_verify": "Weryfikacja",
+    "ph_resume": "Wznawianie",
+    "ph_lock": "Ustawianie bitów blokady",
+    "st_ready": "System gotowy.",
+    "st_dump_ready": "Zrzut gotowy.",
+    "st_flash_ok": "Sukces: zapis i weryfikacja OK!",
+    "st_verify_ok": "Sukces: układ identyczny!",
+    "st_erase_ok": "Sukces: układ skasowany i odblokowany!",
+    "st_lock_ok": "Sukces: układ zablokowany (ochrona odczytu)!",
+    "err_no_response": "Błąd: układ nie odpowiada",
+    "err_fs_write": "Błąd: zapis do FS nieudany",
+    "err_file_missing": "Błąd: brak pliku!",
+    "err_no_checkpoint": "Błąd: brak prawidłowego punktu kontrolnego!",
+    "err_erase": "Błąd: kasowanie nieudane!",
+    "err_erase_page": "Błąd: kasowanie nieudane @ {addr}",
+    "err_write": "Błąd: zapis nieudany @ {addr} (można wznowić)",
+    "err_mismatch": "Błąd: niezgodność @ {addr} (Ocz:{exp} Odcz:{act})",
+    "err_verify": "Błąd: weryfikacja nieudana @ {addr}",
+    "err_unknown": "Błąd: nieznany stan",
+    "err_link": "Błąd: zakłócone łącze debug @ {addr} (błędna suma kontrolna)",
+    "link_retries": "{n} powtórzeń, zegar {clk} µs",
+    "ph_repair": "Ponowne programowanie strony",
+    "page_repairs": "naprawione strony: {n}",
+    "lbl_range": "Zakres",
+    "lbl_range_fw": "Od adresu",
+    "ph_range_all": "całość",
+    "err_range": "Błąd: nieprawidłowy zakres @ {addr} (poza flash lub nie na granicy strony)",
+    "lbl_preserve": "Zachowaj",
+    "ph_preserve": "Zapisywanie chronionych obszarów",
+    "err_preserve": "Błąd: chronione obszary za duże (maks. 16 KB) lub brak pamięci"
   },
   "cs": {
     "title": "TI CC Flasher",
@@ -273,15 +519,56 @@ const char languages_json[] PROGMEM = R"rawliteral(
     "msg_erase_warn": "Vymazat celý čip?\n\nVšechna data budou ztracena!",
     "sec_registers": "Registry",
     "sec_gpio": "GPIO Porty",
+    "sec_watch": "Živé proměnné",
     "sec_xdata": "XDATA PAMĚŤ",
     "btn_halt": "STOP (Halt)",
     "btn_resume": "START (Run)",
     "btn_step": "KROK (Step)",
+    "btn_step_over": "PŘESKOČIT (Over)",
+    "btn_step_out": "VYSTOUPIT (Out)",
     "btn_refresh": "Obnovit",
     "lbl_len": "Délka:",
     "btn_go": "JÍT",
     "msg_wait_debug": "Čekám na data...",
-    "msg_loading": "Načítání..."
+    "msg_loading": "Načítání...",
+    "btn_resume_flash": "Pokračovat ve flashování",
+    "ph_idle": "Nečinný",
+    "ph_init": "Inicializace debug režimu",
+    "ph_detect": "Detekce čipu",
+    "ph_prepare": "Příprava",
+    "ph_erase": "Mazání čipu",
+    "ph_read": "Čtení flash",
+    "ph_write": "Zápis",
+    "ph_verify": "Ověřování",
+    "ph_resume": "Obnovování",
+    "ph_lock": "Nastavování zamykacích bitů",
+    "st_ready": "Systém připraven.",
+    "st_dump_ready": "Výpis připraven.",
+    "st_flash_ok": "Úspěch: flash a ověření OK!",
+    "st_verify_ok": "Úspěch: čip je shodný!",
+    "st_erase_ok": "Úspěch: čip vymazán a odemčen!",
+    "st_lock_ok": "Úspěch: čip zamčen (chráněn proti čtení)!",
+    "err_no_response": "Chyba: čip neodpovídá",
+    "err_fs_write": "Chyba: zápis do FS selhal",
+    "err_file_missing": "Chyba: soubor chybí!",
+    "err_no_checkpoint": "Chyba: žádný platný kontrolní bod!",
+    "err_erase": "Chyba: mazání selhalo!",
+    "err_erase_page": "Chyba: mazání selhalo @ {addr}",
+    "err_write": "Chyba: zápis selhal @ {addr} (lze obnovit)",
+    "err_mismatch": "Chyba: neshoda @ {addr} (Oček:{exp} Skut:{act})",
+    "err_verify": "Chyba: ověření selhalo @ {addr}",
+    "err_unknown": "Chyba: neznámý stav",
+    "err_link": "Chyba: rušené ladicí spojení @ {addr} (chybný kontrolní součet)",
+    "link_retries": "{n} opakování, takt {clk} µs",
+    "ph_repair": "Přeprogramování stránky",
+    "page_repairs": "opravené stránky: {n}",
+    "lbl_range": "Rozsah",
+    "lbl_range_fw": "Od adresy",
+    "ph_range_all": "vše",
+    "err_range": "Chyba: neplatný rozsah @ {addr} (mimo flash nebo nezarovnaný na stránku)",
+    "lbl_preserve": "Zachovat",
+    "ph_preserve": "Ukládání chráněných oblastí",
+    "err_preserve": "Chyba: chráněné oblasti příliš velké (max. 16 KB) nebo nedostatek paměti"
   },
   "ja": {
     "title": "TI CC フラッシャー",
@@ -313,15 +600,56 @@ const char languages_json[] PROGMEM = R"rawliteral(
     "msg_erase_warn": "チップ全体を消去しますか？\n\n全データが失われます！",
     "sec_registers": "レジスタ",
     "sec_gpio": "GPIO ポート",
+    "sec_watch": "ライブ変数",
     "sec_xdata": "XDATA メモリ",
     "btn_halt": "停止 (Halt)",
     "btn_resume": "実行 (Run)",
     "btn_step": "ステップ (Step)",
+    "btn_step_over": "ステップオーバー",
+    "btn_step_out": "ステップアウト",
     "btn_refresh": "更新",
     "lbl_len": "長さ:",
     "btn_go": "読込",
     "msg_wait_debug": "デバッグデータ待機中...",
-    "msg_loading": "読み込み中..."
+    "msg_loading": "読み込み中...",
+    "btn_resume_flash": "書き込みを再開",
+    "ph_idle": "待機中",
+    "ph_init": "デバッグモード初期化",
+    "ph_detect": "チップ検出中",
+    "ph_prepare": "準備中",
+    "ph_erase": "チップ消去中",
+    "ph_read": "フラッシュ読み出し",
+    "ph_write": "書き込み中",
+    "ph_verify": "検証中",
+    "ph_resume": "再開中",
+    "ph_lock": "ロックビット設定中",
+    "st_ready": "システム準備完了。",
+    "st_dump_ready": "ダンプ完了。",
+    "st_flash_ok": "成功：書き込みと検証OK！",
+    "st_verify_ok": "成功：チップは一致しています！",
+    "st_erase_ok": "成功：チップを消去・ロック解除しました！",
+    "st_lock_ok": "成功：チップをロックしました（読み出し保護）！",
+    "err_no_response": "エラー：チップが応答しません",
+    "err_fs_write": "エラー：FS書き込み失敗",
+    "err_file_missing": "エラー：ファイルがありません！",
+    "err_no_checkpoint": "エラー：有効なチェックポイントがありません！",
+    "err_erase": "エラー：消去失敗！",
+    "err_erase_page": "エラー：消去失敗 @ {addr}",
+    "err_write": "エラー：書き込み失敗 @ {addr}（再開可能）",
+    "err_mismatch": "エラー：不一致 @ {addr}（期待値:{exp} 実際:{act}）",
+    "err_verify": "エラー：検証失敗 @ {addr}",
+    "err_unknown": "エラー：不明な状態",
+    "err_link": "エラー: デバッグリンク異常 @ {addr} (チェックサム不一致)",
+    "link_retries": "再試行 {n} 回, クロック {clk} µs",
+    "ph_repair": "ページ再書き込み中",
+    "page_repairs": "{n} ページ修復",
+    "lbl_range": "範囲",
+    "lbl_range_fw": "開始アドレス",
+    "ph_range_all": "全体",
+    "err_range": "エラー: 無効な範囲 @ {addr} (フラッシュ外またはページ境界でない)",
+    "lbl_preserve": "保持",
+    "ph_preserve": "保護領域を保存中",
+    "err_preserve": "エラー: 保護領域が大きすぎる (最大 16 KB) またはメモリ不足"
   },
   "zh": {
     "title": "TI CC 烧录工具",
@@ -353,15 +681,56 @@ const char languages_json[] PROGMEM = R"rawliteral(
     "msg_erase_warn": "擦除整个芯片？\n\n所有数据将丢失！",
     "sec_registers": "寄存器",
     "sec_gpio": "GPIO 端口",
+    "sec_watch": "实时变量",
     "sec_xdata": "XDATA 内存",
     "btn_halt": "暂停 (Halt)",
     "btn_resume": "运行 (Run)",
     "btn_step": "单步 (Step)",
+    "btn_step_over": "单步跳过 (Over)",
+    "btn_step_out": "单步跳出 (Out)",
     "btn_refresh": "刷新",
     "lbl_len": "长度:",
     "btn_go": "读取",
     "msg_wait_debug": "等待调试数据...",
-    "msg_loading": "加载中..."
+    "msg_loading": "加载中...",
+    "btn_resume_flash": "继续烧录",
+    "ph_idle": "空闲",
+    "ph_init": "初始化调试模式",
+    "ph_detect": "检测芯片",
+    "ph_prepare": "准备中",
+    "ph_erase": "擦除芯片",
+    "ph_read": "读取闪存",
+    "ph_write": "写入中",
+    "ph_verify": "校验中",
+    "ph_resume": "恢复中",
+    "ph_lock": "设置锁定位",
+    "st_ready": "系统就绪。",
+    "st_dump_ready": "转储完成。",
+    "st_flash_ok": "成功：烧录并校验通过！",
+    "st_verify_ok": "成功：芯片内容一致！",
+    "st_erase_ok": "成功：芯片已擦除并解锁！",
+    "st_lock_ok": "成功：芯片已锁定（读保护）！",
+    "err_no_response": "错误：芯片无响应",
+    "err_fs_write": "错误：文件系统写入失败",
+    "err_file_missing": "错误：文件缺失！",
+    "err_no_checkpoint": "错误：没有有效的检查点！",
+    "err_erase": "错误：擦除失败！",
+    "err_erase_page": "错误：擦除失败 @ {addr}",
+    "err_write": "错误：写入失败 @ {addr}（可恢复）",
+    "err_mismatch": "错误：不匹配 @ {addr}（期望:{exp} 实际:{act}）",
+    "err_verify": "错误：校验失败 @ {addr}",
+    "err_unknown": "错误：未知状态",
+    "err_link": "错误：调试链路受干扰 @ {addr}（校验和不匹配）",
+    "link_retries": "重试 {n} 次，时钟 {clk} µs",
+    "ph_repair": "正在重新编程页面",
+    "page_repairs": "已修复 {n} 页",
+    "lbl_range": "范围",
+    "lbl_range_fw": "起始地址",
+    "ph_range_all": "全部",
+    "err_range": "错误：范围无效 @ {addr}（超出闪存或未按页对齐）",
+    "lbl_preserve": "保留",
+    "ph_preserve": "正在保存保留区域",
+    "err_preserve": "错误：保留区域过大（最大 16 KB）或内存不足"
   }
 }
 )rawliteral";
\ No newline at end of file
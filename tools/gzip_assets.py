@@ -0,0 +1,90 @@
+# Pre-build step (PlatformIO extra_script, also runs standalone: python3 tools/gzip_assets.py)
+#
+# Gzips the web assets from src/web_index.h, src/web_js.h and src/web_lang.h
+# into src/web_assets_gz.h, each with a content hash as ETag. The languages
+# become one compact asset per language (/api/lang/<code>). The page loads
+# script and languages as "...?v=<hash>", so the browser may cache them as
+# immutable: a firmware with other assets uses other URLs.
+import gzip
+import hashlib
+import json
+import os
+import re
+
+try:
+    Import("env")  # noqa: F821 (SCons)
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SRC = os.path.join(PROJECT_DIR, "src")
+OUT = os.path.join(SRC, "web_assets_gz.h")
+
+
+def raw_literal(header, name):
+    text = open(os.path.join(SRC, header), encoding="utf-8").read()
+    m = re.search(r"const char " + name + r"\[\] PROGMEM = R\"rawliteral\((.*?)\)rawliteral\";", text, re.S)
+    if not m:
+        raise SystemExit("gzip_assets: %s not found in %s" % (name, header))
+    return m.group(1)
+
+
+def versioned(text, old, new):
+    if old not in text:
+        raise SystemExit("gzip_assets: %s not found, cannot add the version" % old)
+    return text.replace(old, new)
+
+
+def etag(data):
+    return hashlib.sha1(data.encode("utf-8")).hexdigest()[:12]
+
+
+def c_array(name, data, mime, tag):
+    gz = gzip.compress(data.encode("utf-8"), 9, mtime=0)
+    lines = []
+    for i in range(0, len(gz), 20):
+        lines.append("    " + ", ".join("0x%02X" % b for b in gz[i:i + 20]) + ",")
+    return ("const uint8_t %s_gz[] PROGMEM = {\n%s\n};\n"
+            "const WebAsset %s = { %s_gz, sizeof(%s_gz), \"%s\", \"\\\"%s\\\"\" }; // %d -> %d bytes\n"
+            % (name, "\n".join(lines), "ASSET_" + name.upper(), name, name, mime, tag, len(data.encode("utf-8")), len(gz)))
+
+
+def main():
+    languages = json.loads(raw_literal("web_lang.h", "languages_json"))
+    lang_json = {code: json.dumps(texts, ensure_ascii=False, separators=(",", ":")) for code, texts in languages.items()}
+    lang_tags = {code: etag(data) for code, data in lang_json.items()}
+
+    js = raw_literal("web_js.h", "javaScript")
+    js = versioned(js, "const LANG_VER = {};", "const LANG_VER = %s;" % json.dumps(lang_tags, separators=(",", ":")))
+    js_tag = etag(js)
+
+    html = raw_literal("web_index.h", "index_html")
+    html = versioned(html, 'src="/script.js"', 'src="/script.js?v=%s"' % js_tag)
+    html_tag = etag(html)
+
+    out = ("// Generated by tools/gzip_assets.py from web_index.h, web_js.h and web_lang.h - do not edit\n"
+           "#pragma once\n#include <Arduino.h>\n\n"
+           "struct WebAsset {\n"
+           "    const uint8_t* data;   // gzip\n"
+           "    size_t len;\n"
+           "    const char* type;\n"
+           "    const char* etag;\n"
+           "};\n\n")
+    out += c_array("index_html", html, "text/html", html_tag) + "\n"
+    out += c_array("script_js", js, "application/javascript", js_tag) + "\n"
+    for code, data in lang_json.items():
+        out += c_array("lang_" + code, data, "application/json", lang_tags[code]) + "\n"
+    codes = list(lang_json)
+    out += "const uint8_t LANG_COUNT = %d;\n" % len(codes)
+    out += "const char* const LANG_CODES[] = { %s };\n" % ", ".join('"%s"' % c for c in codes)
+    out += "const WebAsset LANG_ASSETS[] = { %s };\n" % ", ".join("ASSET_LANG_" + c.upper() for c in codes)
+
+    # Unchanged assets: keep the timestamp, main.cpp is not rebuilt
+    if os.path.exists(OUT) and open(OUT, encoding="utf-8").read() == out:
+        return
+    with open(OUT, "w", encoding="utf-8") as f:
+        f.write(out)
+    print("gzip_assets: wrote %s" % os.path.relpath(OUT, PROJECT_DIR))
+
+
+main()